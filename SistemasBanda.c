@@ -0,0 +1,243 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "utils.h"
+#include "arena.h"
+#include "instrumenta.h"
+#include "SistemasBanda.h"
+
+/*  Os métodos só acessam os coeficientes dentro da banda: a fatoração custa
+    O(n·kl·(kl+ku)) operações e ocupa O(n·(2kl+ku+1)) de memória, contra
+    O(n³) e n² da eliminação densa.
+*/
+
+void detectaBanda (SistLinear_t *SL)
+{
+    unsigned int n = SL->n, i, j, kl = 0, ku = 0;
+
+    for (i = 0; i < n; i++){
+        // Não nulos mais distantes da diagonal em cada lado da linha
+        for (j = 0; j + kl < i; j++)
+            if (SL->A[i][j] != 0.0f){
+                kl = i - j;
+                break;
+            }
+        for (j = n - 1; j > i + ku; j--)
+            if (SL->A[i][j] != 0.0f){
+                ku = j - i;
+                break;
+            }
+    }
+
+    SL->kl = kl;
+    SL->ku = ku;
+}
+
+
+void liberaBandaLU (BandaLU_t *B)
+{
+    arenaRetorna(B->marca);
+}
+
+
+/*!
+  \brief Fatoração LU em banda com pivoteamento parcial
+
+  \param SL Ponteiro para o sistema linear
+
+  \return fatoração. NULL se a matriz é singular
+  */
+BandaLU_t *fatoraBanda (SistLinear_t *SL)
+{
+    unsigned int n = SL->n, kl = SL->kl, ku = SL->ku, i, j, k, p;
+
+    MarcaArena_t marca = arenaMarca();
+    BandaLU_t *B = arenaAloca(sizeof(BandaLU_t));
+    B->marca = marca;
+    B->n = n;
+    B->kl = kl;
+    B->ku = ku;
+    B->w = 2 * kl + ku + 1;
+    B->AB = arenaZera(sizeof(real_t) * (size_t) n * B->w);
+    B->ipiv = arenaAloca(sizeof(unsigned int) * n);
+
+    const unsigned int w = B->w;
+    real_t *AB = B->AB;
+    #define BANDA(i, j) AB[(size_t) (i) * w + (j) - (i) + kl]
+
+    for (i = 0; i < n; i++){
+        unsigned int ini = i > kl ? i - kl : 0, fim = i + ku < n ? i + ku : n - 1;
+        for (j = ini; j <= fim; j++)
+            BANDA(i, j) = SL->A[i][j];
+    }
+
+    for (k = 0; k < n; k++){
+        unsigned int ultLin = k + kl < n ? k + kl : n - 1;
+        unsigned int ultCol = k + kl + ku < n ? k + kl + ku : n - 1;
+
+        INSTR_INICIO(FASE_PIVO);
+        p = k;
+        for (i = k + 1; i <= ultLin; i++)
+            if (fabsf(BANDA(i, k)) > fabsf(BANDA(p, k)))
+                p = i;
+        B->ipiv[k] = p;
+        INSTR_FIM(FASE_PIVO);
+
+        if (BANDA(p, k) == 0.0f){
+            fprintf(stderr, "Gauss-Jordan floating point error.\n");
+            liberaBandaLU(B);
+            return NULL;
+        }
+
+        if (p != k){
+            INSTR_INICIO(FASE_TROCA);
+            for (j = k; j <= ultCol; j++){
+                real_t aux = BANDA(k, j);
+                BANDA(k, j) = BANDA(p, j);
+                BANDA(p, j) = aux;
+            }
+            INSTR_FIM(FASE_TROCA);
+        }
+
+        INSTR_INICIO(FASE_ELIMINACAO);
+        real_t pivo = BANDA(k, k);
+        for (i = k + 1; i <= ultLin; i++){
+            real_t m = BANDA(i, k) / pivo;
+            BANDA(i, k) = m;
+            if (m != 0.0f)
+                for (j = k + 1; j <= ultCol; j++)
+                    BANDA(i, j) -= m * BANDA(k, j);
+        }
+        INSTR_FIM(FASE_ELIMINACAO);
+
+        if (vetor_invalido(&BANDA(k, k), ultCol - k + 1)){
+            fprintf(stderr, "Gauss-Jordan floating point error.\n");
+            liberaBandaLU(B);
+            return NULL;
+        }
+    }
+
+    #undef BANDA
+    return B;
+}
+
+
+int bandaSolve (BandaLU_t *B, real_t *b, real_t *x)
+{
+    unsigned int n = B->n, kl = B->kl, w = B->w, i, j, k;
+    real_t *AB = B->AB;
+    #define BANDA(i, j) AB[(size_t) (i) * w + (j) - (i) + kl]
+
+    INSTR_INICIO(FASE_SUBSTITUICAO);
+    if (x != b)
+        memcpy(x, b, sizeof(real_t) * n);
+
+    // Ly = Pb, aplicando as trocas na ordem em que foram feitas
+    for (k = 0; k < n; k++){
+        unsigned int p = B->ipiv[k], ultLin = k + kl < n ? k + kl : n - 1;
+        if (p != k){
+            real_t aux = x[k];
+            x[k] = x[p];
+            x[p] = aux;
+        }
+        for (i = k + 1; i <= ultLin; i++)
+            x[i] -= BANDA(i, k) * x[k];
+    }
+
+    // Ux = y
+    for (i = n; i-- > 0; ){
+        unsigned int ultCol = i + w - kl - 1 < n ? i + w - kl - 1 : n - 1;
+        double sum = x[i];
+        for (j = i + 1; j <= ultCol; j++)
+            sum -= BANDA(i, j) * x[j];
+        x[i] = sum / BANDA(i, i);
+    }
+    INSTR_FIM(FASE_SUBSTITUICAO);
+
+    #undef BANDA
+
+    if (vetor_invalido(x, n)){
+        fprintf(stderr, "Retrosubs floating point failure.\n");
+        return -1;
+    }
+    return 0;
+}
+
+
+int thomas (SistLinear_t *SL, real_t *x)
+{
+    unsigned int n = SL->n, i;
+    real_t **A = SL->A;
+
+    // Sem pivoteamento, só é estável com diagonal dominante
+    for (i = 0; i < n; i++){
+        real_t fora = (i > 0 ? fabsf(A[i][i - 1]) : 0.0f) + (i + 1 < n ? fabsf(A[i][i + 1]) : 0.0f);
+        if (fabsf(A[i][i]) < fora)
+            return -1;
+    }
+
+    MarcaArena_t marca = arenaMarca();
+    real_t *c = arenaAloca(sizeof(real_t) * n); // superdiagonal após a eliminação
+
+    real_t d = A[0][0];
+    if (d == 0.0f){
+        arenaRetorna(marca);
+        return -1;
+    }
+
+    // A eliminação já aplica a substituição direta em x
+    INSTR_INICIO(FASE_ELIMINACAO);
+    c[0] = n > 1 ? A[0][1] / d : 0.0f;
+    x[0] = SL->b[0] / d;
+
+    for (i = 1; i < n; i++){
+        d = A[i][i] - A[i][i - 1] * c[i - 1];
+        if (d == 0.0f){
+            INSTR_FIM(FASE_ELIMINACAO);
+            arenaRetorna(marca);
+            return -1;
+        }
+        c[i] = i + 1 < n ? A[i][i + 1] / d : 0.0f;
+        x[i] = (SL->b[i] - A[i][i - 1] * x[i - 1]) / d;
+    }
+    INSTR_FIM(FASE_ELIMINACAO);
+
+    INSTR_INICIO(FASE_SUBSTITUICAO);
+    for (i = n - 1; i-- > 0; )
+        x[i] -= c[i] * x[i + 1];
+    INSTR_FIM(FASE_SUBSTITUICAO);
+
+    arenaRetorna(marca);
+
+    // Sem mensagem: eliminacaoGaussBanda tenta a fatoração LU em banda, que relata a falha
+    return vetor_invalido(x, n) ? -1 : 0;
+}
+
+
+/*!
+  \brief Eliminação de Gauss para SL em banda
+
+  Tridiagonais com diagonal dominante usam o algoritmo de Thomas, que
+  dispensa pivoteamento; as demais, a fatoração LU em banda.
+
+  \param SL Ponteiro para o sistema linear
+  \param x ponteiro para o vetor solução
+
+  \return código de erro. 0 em caso de sucesso.
+  */
+int eliminacaoGaussBanda (SistLinear_t *SL, real_t *x)
+{
+    if (SL->kl <= 1 && SL->ku <= 1 && thomas(SL, x) == 0)
+        return 0;
+
+    BandaLU_t *B = fatoraBanda(SL);
+    if (!B)
+        return -1;
+
+    int result = bandaSolve(B, SL->b, x);
+    liberaBandaLU(B);
+
+    return result;
+}
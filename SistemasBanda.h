@@ -0,0 +1,37 @@
+#ifndef __SISBANDA_H__
+#define __SISBANDA_H__
+
+#include "SistemasLineares.h"
+#include "arena.h"
+
+// Usa os métodos de banda quando a banda ocupa menos da metade das colunas
+#define SL_BANDA(SL) (2 * ((SL)->kl + (SL)->ku) < (SL)->n)
+
+// Fatoração LU em banda com pivoteamento parcial. A linha i guarda as colunas
+// i-kl .. i+kl+ku (as trocas de linha alargam U de ku para kl+ku diagonais)
+typedef struct {
+  unsigned int n, kl, ku;
+  unsigned int w; // largura de cada linha: 2kl+ku+1
+  real_t *AB; // elemento (i,j) em AB[i*w + j-i+kl]; L abaixo da diagonal, U no restante
+  unsigned int *ipiv; // no passo k, a linha k foi trocada com a linha ipiv[k]
+  MarcaArena_t marca; // a fatoração fica na área de trabalho, a partir daqui
+} BandaLU_t;
+
+// Calcula as larguras de banda kl e ku de SL
+void detectaBanda (SistLinear_t *SL);
+
+BandaLU_t *fatoraBanda (SistLinear_t *SL);
+void liberaBandaLU (BandaLU_t *B);
+
+// Resolve LUx = Pb com a fatoração em banda. 'b' e 'x' podem coincidir
+int bandaSolve (BandaLU_t *B, real_t *b, real_t *x);
+
+// Algoritmo de Thomas (sem pivoteamento) para kl, ku <= 1. Falha (-1) se A não
+// tem diagonal dominante, caso em que não é estável, se algum pivô se anula ou
+// se x não é finito, sempre sem mensagem
+int thomas (SistLinear_t *SL, real_t *x);
+
+// Mesma semântica de eliminacaoGauss (sem medir tempo). Exige SL_BANDA(SL)
+int eliminacaoGaussBanda (SistLinear_t *SL, real_t *x);
+
+#endif // __SISBANDA_H__
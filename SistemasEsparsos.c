@@ -0,0 +1,679 @@
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+
+#include "utils.h"
+#include "arena.h"
+#include "instrumenta.h"
+#include "arquivos.h"
+#include "SistemasEsparsos.h"
+
+
+/*!
+  \brief Alocaçao de memória
+
+  \param n tamanho do SL
+  \param nnz número de coeficientes não nulos
+
+  \return ponteiro para SL
+  */
+SistLinearCSR_t *alocaSistLinearCSR (unsigned int n, unsigned int nnz)
+{
+    SistLinearCSR_t *new = (SistLinearCSR_t*) malloc(sizeof(SistLinearCSR_t));
+    must_alloc(new, __func__);
+
+    new->n = n;
+    new->nnz = nnz;
+    new->erro = (real_t) 0.0f;
+
+    new->val = (real_t*) malloc(nnz * sizeof(real_t));
+    must_alloc(new->val, __func__);
+
+    new->col = (unsigned int*) malloc(nnz * sizeof(unsigned int));
+    must_alloc(new->col, __func__);
+
+    new->lin = (unsigned int*) calloc(n + 1, sizeof(unsigned int));
+    must_alloc(new->lin, __func__);
+
+    new->b = (real_t*) calloc(n, sizeof(real_t));
+    must_alloc(new->b, __func__);
+
+    return new;
+}
+
+
+/*!
+  \brief Liberaçao de memória
+
+  \param sistema linear SL
+  */
+void liberaSistLinearCSR (SistLinearCSR_t *SL)
+{
+    free(SL->val);
+    free(SL->col);
+    free(SL->lin);
+    free(SL->b);
+    free(SL);
+}
+
+
+/*!
+  \brief Converte um SL denso para CSR, descartando os coeficientes nulos
+
+  \param SL Ponteiro para o sistema linear denso
+
+  \return sistema linear esparso
+  */
+SistLinearCSR_t *densoParaCSR (SistLinear_t *SL)
+{
+    unsigned int nnz = 0, i, j;
+    for (i = 0; i < SL->n; i++)
+        for (j = 0; j < SL->n; j++)
+            if (SL->A[i][j] != 0.0f)
+                nnz++;
+
+    SistLinearCSR_t *new = alocaSistLinearCSR(SL->n, nnz);
+    new->erro = SL->erro;
+
+    nnz = 0;
+    for (i = 0; i < SL->n; i++){
+        for (j = 0; j < SL->n; j++)
+            if (SL->A[i][j] != 0.0f){
+                new->val[nnz] = SL->A[i][j];
+                new->col[nnz] = j;
+                nnz++;
+            }
+        new->lin[i + 1] = nnz;
+    }
+    memcpy(new->b, SL->b, sizeof(real_t) * SL->n);
+
+    return new;
+}
+
+
+/*!
+  \brief Leitura de SL esparso a partir de Entrada padrão (stdin).
+
+  Formato: "n nnz", erro, nnz triplas "i j valor" (índices a partir de 0,
+  em qualquer ordem e sem repetições) e os n termos independentes.
+
+  \return sistema linear SL. NULL se houve erro de leitura
+  */
+SistLinearCSR_t *lerSistLinearCSR ()
+{
+    unsigned int n, nnz, k;
+    real_t erro;
+    if (!leInteiro(&n) || !leInteiro(&nnz) || !leReal(&erro))
+        return NULL;
+
+    unsigned int *li = malloc(nnz * sizeof(unsigned int));
+    must_alloc(li, __func__);
+    unsigned int *co = malloc(nnz * sizeof(unsigned int));
+    must_alloc(co, __func__);
+    real_t *va = malloc(nnz * sizeof(real_t));
+    must_alloc(va, __func__);
+
+    SistLinearCSR_t *SL = alocaSistLinearCSR(n, nnz);
+    SL->erro = erro;
+
+    for (k = 0; k < nnz; k++)
+        if (!leInteiro(&li[k]) || !leInteiro(&co[k]) || !leReal(&va[k]) || li[k] >= n || co[k] >= n){
+            fprintf(stderr, "Invalid sparse entry %u.\n", k);
+            free(li); free(co); free(va);
+            liberaSistLinearCSR(SL);
+            return NULL;
+        }
+
+    for (k = 0; k < n; k++)
+        if (!leReal(&(SL->b[k]))){
+            fprintf(stderr, "Invalid right-hand side entry %u.\n", k);
+            free(li); free(co); free(va);
+            liberaSistLinearCSR(SL);
+            return NULL;
+        }
+
+    // Ordena as triplas por linha (contagem), mantendo a ordem de leitura dentro da linha
+    for (k = 0; k < nnz; k++)
+        SL->lin[li[k] + 1]++;
+    for (k = 0; k < n; k++)
+        SL->lin[k + 1] += SL->lin[k];
+
+    unsigned int *pos = malloc(n * sizeof(unsigned int));
+    must_alloc(pos, __func__);
+    memcpy(pos, SL->lin, n * sizeof(unsigned int));
+
+    for (k = 0; k < nnz; k++){
+        SL->val[pos[li[k]]] = va[k];
+        SL->col[pos[li[k]]] = co[k];
+        pos[li[k]]++;
+    }
+
+    free(pos);
+    free(li);
+    free(co);
+    free(va);
+
+    return SL;
+}
+
+
+// Calcula em res o resíduo de um sistema linear esparso e sua solução
+void residueCSR (SistLinearCSR_t *SL, real_t *x, real_t *res)
+{
+    double ax;
+    for (unsigned int i = 0; i < SL->n; i++){
+        ax = 0.0f;
+        for (unsigned int k = SL->lin[i]; k < SL->lin[i + 1]; k++)
+            ax += SL->val[k] * x[SL->col[k]];
+        res[i] = SL->b[i] - ax;
+    }
+}
+
+
+// Retorna a norma L2 do resíduo
+real_t normaL2ResiduoCSR (SistLinearCSR_t *SL, real_t *res)
+{
+    double sum = 0.0f;
+    for (unsigned int i = 0; i < SL->n; i++)
+        sum += res[i] * res[i];
+    return sqrt(sum);
+}
+
+
+// Retorna o coeficiente diagonal da linha i (0 se não armazenado)
+static real_t diagonal (SistLinearCSR_t *SL, unsigned int i)
+{
+    for (unsigned int k = SL->lin[i]; k < SL->lin[i + 1]; k++)
+        if (SL->col[k] == i)
+            return SL->val[k];
+    return 0.0f;
+}
+
+
+int jacobi_convergeCSR (SistLinearCSR_t *SL)
+{
+    double sum;
+    for (unsigned int i = 0; i < SL->n; i++){
+        sum = 0.0f;
+        for (unsigned int k = SL->lin[i]; k < SL->lin[i + 1]; k++)
+            if (SL->col[k] != i)
+                sum += fabs(SL->val[k]);
+        if (sum / fabs(diagonal(SL, i)) > 1.0f)
+            return 0;
+    }
+
+    return 1;
+}
+
+
+int seidel_convergeCSR (SistLinearCSR_t *SL)
+{
+    MarcaArena_t marca = arenaMarca();
+    double *betas = arenaAloca(sizeof(double) * SL->n);
+
+    double sum;
+    for (unsigned int i = 0; i < SL->n; i++){
+        sum = 0.0f;
+        for (unsigned int k = SL->lin[i]; k < SL->lin[i + 1]; k++){
+            unsigned int j = SL->col[k];
+            if (j < i)
+                sum += betas[j] * fabs(SL->val[k]);
+            else if (j > i)
+                sum += fabs(SL->val[k]);
+        }
+
+        betas[i] = sum / fabs(diagonal(SL, i));
+        if (betas[i] > 1.0f){
+            arenaRetorna(marca);
+            return 0;
+        }
+    }
+    arenaRetorna(marca);
+    return 1;
+}
+
+
+/*!
+  \brief Método de Jacobi para SL esparso
+
+  \param SL Ponteiro para o sistema linear
+  \param x ponteiro para o vetor solução. Ao iniciar função contém
+            valor inicial
+  \param tTotal time gasto pelo método
+
+  \return código de erro. Um nr positivo indica sucesso e o nr
+          de iterações realizadas. Um nr. negativo indica um erro:
+          -1 (não converge) -2 (sem solução)
+*/
+int gaussJacobiCSR (SistLinearCSR_t *SL, real_t *x, double *tTotal)
+{
+    if (!jacobi_convergeCSR(SL)){
+        fprintf(stderr, "Gauss-Jacobi doesn't converge.\n");
+        return -1;
+    }
+
+    MarcaArena_t marca = arenaMarca();
+    real_t* curr_iter = arenaAloca(SL->n * sizeof(real_t)); // Valores usados na atual iteração
+    real_t* next_iter = arenaAloca(SL->n * sizeof(real_t)); // Valores calculados na atual iteração
+    memcpy(curr_iter, x, sizeof(real_t) * SL->n);
+
+    real_t diff = FLT_MAX; // A maior diferença entre as iterações
+    int erro = 0, paralelo = numThreads() > 1 && SL->n >= ITER_PARALELO;
+
+    int iter, i;
+    double time = timestamp();
+    for (iter = 0; iter < MAXIT && diff > SL->erro; iter++){
+        diff = 0.0f;
+
+        INSTR_INICIO(FASE_VARREDURA);
+        #pragma omp parallel for reduction(max: diff) if(paralelo)
+        for (i = 0; i < SL->n; i++){
+            double sum = 0.0f;
+            real_t pivo = 0.0f;
+            for (unsigned int k = SL->lin[i]; k < SL->lin[i + 1]; k++){
+                if (SL->col[k] != i)
+                    sum += SL->val[k] * curr_iter[SL->col[k]];
+                else
+                    pivo = SL->val[k];
+            }
+
+            if (pivo == 0.0f && (SL->b[i] - sum) != 0.0f){
+                #pragma omp atomic write
+                erro = -2;
+                continue;
+            }
+            next_iter[i] = (SL->b[i] - sum) / pivo;
+
+            real_t d = fabs(next_iter[i] - curr_iter[i]);
+            if (d > diff)
+                diff = d;
+        }
+        INSTR_FIM(FASE_VARREDURA);
+
+        INSTR_INICIO(FASE_CONVERGENCIA);
+        if (!erro && vetor_invalido(next_iter, SL->n))
+            erro = -3;
+        INSTR_FIM(FASE_CONVERGENCIA);
+
+        if (erro){
+            fprintf(stderr, erro == -2 ? "Gauss-Jacobi no solution.\n" : "Gauss-Jacobi floating point error.\n");
+            arenaRetorna(marca);
+            return erro;
+        }
+
+        real_t *aux = curr_iter;
+        curr_iter = next_iter;
+        next_iter = aux;
+    }
+
+    *tTotal = timestamp() - time;
+    memcpy(x, curr_iter, sizeof(real_t) * SL->n);
+
+    arenaRetorna(marca);
+
+    return iter;
+}
+
+
+/*!
+  \brief Método de Gauss-Seidel para SL esparso
+
+  \param SL Ponteiro para o sistema linear
+  \param x ponteiro para o vetor solução. Ao iniciar função contém
+            valor inicial
+  \param tTotal time gasto pelo método
+
+  \return código de erro. Um nr positivo indica sucesso e o nr
+          de iterações realizadas. Um nr. negativo indica um erro:
+          -1 (não converge) -2 (sem solução)
+  */
+int gaussSeidelCSR (SistLinearCSR_t *SL, real_t *x, double *tTotal)
+{
+    if (!seidel_convergeCSR(SL)){
+        fprintf(stderr, "Gauss-Seidel doesn't converge.\n");
+        return -1;
+    }
+
+    MarcaArena_t marca = arenaMarca();
+    real_t* curr_iter = arenaAloca(SL->n * sizeof(real_t)); // Valores da iteração atual
+    memcpy(curr_iter, x, sizeof(real_t) * SL->n);
+
+    real_t diff = FLT_MAX; // A maior diferença entre as iterações
+
+    int iter, i;
+    double sum, time = timestamp();
+    for (iter = 0; iter < MAXIT && diff > SL->erro; iter++){
+        diff = 0.0f;
+        INSTR_INICIO(FASE_VARREDURA);
+        for (i = 0; i < SL->n; i++){
+            sum = 0.0f;
+            real_t pivo = 0.0f;
+            for (unsigned int k = SL->lin[i]; k < SL->lin[i + 1]; k++){
+                if (SL->col[k] != i)
+                    sum += SL->val[k] * curr_iter[SL->col[k]];
+                else
+                    pivo = SL->val[k];
+            }
+
+            if (pivo == 0.0f && (SL->b[i] != 0.0f)){
+                fprintf(stderr, "No solution.\n");
+                INSTR_FIM(FASE_VARREDURA);
+                arenaRetorna(marca);
+                return -2;
+            }
+
+            real_t novo = (SL->b[i] - sum) / pivo;
+            if (fabs(novo - curr_iter[i]) > diff)
+                diff = fabs(novo - curr_iter[i]);
+            curr_iter[i] = novo;
+        }
+        INSTR_FIM(FASE_VARREDURA);
+
+        INSTR_INICIO(FASE_CONVERGENCIA);
+        int invalido = vetor_invalido(curr_iter, SL->n);
+        INSTR_FIM(FASE_CONVERGENCIA);
+        if (invalido){
+            fprintf(stderr, "Gauss-Seidel floating point error.\n");
+            arenaRetorna(marca);
+            return -3;
+        }
+    }
+
+    *tTotal = timestamp() - time;
+    memcpy(x, curr_iter, sizeof(real_t) * SL->n);
+
+    arenaRetorna(marca);
+
+    return iter;
+}
+
+
+// Fatoração ILU(0): L (diagonal unitária implícita) e U no padrão de A, com
+// as colunas de cada linha em ordem crescente
+typedef struct {
+    real_t *val;
+    unsigned int *col, *lin;
+    unsigned int *diag; // posição do coeficiente diagonal de cada linha
+} FatorILU_t;
+
+
+/*  ILU(0) na variante IKJ: a linha i é eliminada pelas linhas k < i já
+    fatoradas, atualizando apenas as posições que já existem na linha i
+    (localizadas por 'pos'). O fator, e 'pos' com ele, fica na área de
+    trabalho do chamador. Retorna NULL se falta ou se anula algum pivô
+*/
+static FatorILU_t *fatoraILU (SistLinearCSR_t *SL)
+{
+    unsigned int n = SL->n, i, k, p, q;
+
+    MarcaArena_t marca = arenaMarca();
+    FatorILU_t *M = arenaAloca(sizeof(FatorILU_t));
+    M->val = arenaAloca(sizeof(real_t) * SL->nnz);
+    M->col = arenaAloca(sizeof(unsigned int) * SL->nnz);
+    M->lin = arenaAloca(sizeof(unsigned int) * (n + 1));
+    M->diag = arenaAloca(sizeof(unsigned int) * n);
+
+    memcpy(M->val, SL->val, sizeof(real_t) * SL->nnz);
+    memcpy(M->col, SL->col, sizeof(unsigned int) * SL->nnz);
+    memcpy(M->lin, SL->lin, sizeof(unsigned int) * (n + 1));
+
+    // A leitura mantém a ordem do arquivo dentro da linha: ordena por coluna
+    for (i = 0; i < n; i++)
+        for (p = M->lin[i] + 1; p < M->lin[i + 1]; p++){
+            unsigned int c = M->col[p];
+            real_t v = M->val[p];
+            for (q = p; q > M->lin[i] && M->col[q - 1] > c; q--){
+                M->col[q] = M->col[q - 1];
+                M->val[q] = M->val[q - 1];
+            }
+            M->col[q] = c;
+            M->val[q] = v;
+        }
+
+    int *pos = arenaAloca(sizeof(int) * n);
+    for (i = 0; i < n; i++)
+        pos[i] = -1;
+
+    for (i = 0; i < n; i++){
+        for (p = M->lin[i]; p < M->lin[i + 1]; p++)
+            pos[M->col[p]] = p;
+
+        for (p = M->lin[i]; p < M->lin[i + 1] && (k = M->col[p]) < i; p++){
+            M->val[p] /= M->val[M->diag[k]];
+            for (q = M->diag[k] + 1; q < M->lin[k + 1]; q++)
+                if (pos[M->col[q]] >= 0)
+                    M->val[pos[M->col[q]]] -= M->val[p] * M->val[q];
+        }
+
+        for (q = M->lin[i]; q < M->lin[i + 1]; q++)
+            pos[M->col[q]] = -1;
+
+        if (p == M->lin[i + 1] || M->col[p] != i || M->val[p] == 0.0f){
+            arenaRetorna(marca);
+            return NULL;
+        }
+        M->diag[i] = p;
+    }
+
+    return M;
+}
+
+
+// z = (LU)^-1 v. Sem fatoração, z = v
+static void aplicaILU (FatorILU_t *M, unsigned int n, const double *v, double *z)
+{
+    unsigned int i, p;
+
+    if (!M){
+        memcpy(z, v, sizeof(double) * n);
+        return;
+    }
+
+    INSTR_INICIO(FASE_PRECOND);
+    for (i = 0; i < n; i++){
+        double sum = v[i];
+        for (p = M->lin[i]; p < M->diag[i]; p++)
+            sum -= M->val[p] * z[M->col[p]];
+        z[i] = sum;
+    }
+
+    for (i = n; i-- > 0; ){
+        double sum = z[i];
+        for (p = M->diag[i] + 1; p < M->lin[i + 1]; p++)
+            sum -= M->val[p] * z[M->col[p]];
+        z[i] = sum / M->val[M->diag[i]];
+    }
+    INSTR_FIM(FASE_PRECOND);
+}
+
+
+// w = Av
+static void multiplicaCSR (SistLinearCSR_t *SL, const double *v, double *w, int paralelo)
+{
+    int i;
+    INSTR_INICIO(FASE_VARREDURA);
+    #pragma omp parallel for if(paralelo)
+    for (i = 0; i < SL->n; i++){
+        double sum = 0.0;
+        for (unsigned int k = SL->lin[i]; k < SL->lin[i + 1]; k++)
+            sum += SL->val[k] * v[SL->col[k]];
+        w[i] = sum;
+    }
+    INSTR_FIM(FASE_VARREDURA);
+}
+
+
+static double produtoDuplo (const double *a, const double *b, unsigned int n)
+{
+    double sum = 0.0;
+    for (unsigned int i = 0; i < n; i++)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+
+/*!
+  \brief Método GMRES(GMRES_M) com reinício, precondicionado por ILU(0) à direita
+
+  A base de Krylov, a matriz de Hessenberg e as rotações de Givens são
+  mantidas em double. Para quando ||b - Ax|| <= erro * ||b||; como o
+  precondicionador é aplicado à direita, a estimativa do resíduo durante as
+  iterações é a do próprio sistema. Se ILU(0) falhar, segue sem precondicionador.
+
+  \param SL Ponteiro para o sistema linear
+  \param x ponteiro para o vetor solução. Ao iniciar função contém
+            valor inicial
+  \param tTotal time gasto pelo método
+
+  \return código de erro. Um nr positivo indica sucesso e o nr
+          de iterações realizadas. Um nr. negativo indica um erro:
+          -1 (não converge) -3 (erro de ponto flutuante)
+  */
+int gmresCSR (SistLinearCSR_t *SL, real_t *x, double *tTotal)
+{
+    const unsigned int n = SL->n, m = GMRES_M;
+    unsigned int i, j, k;
+    int paralelo = numThreads() > 1 && n >= ITER_PARALELO;
+
+    double time = timestamp();
+    MarcaArena_t marca = arenaMarca();
+
+    FatorILU_t *M = fatoraILU(SL);
+    if (!M)
+        fprintf(stderr, "GMRES: ILU(0) breakdown, no preconditioner.\n");
+
+    double *V = arenaAloca(sizeof(double) * (m + 1) * n); // base de Krylov, um vetor por linha
+    double *H = arenaZera(sizeof(double) * (m + 1) * m); // Hessenberg, H[i*m + j]
+    double *cs = arenaAloca(sizeof(double) * m);
+    double *sn = arenaAloca(sizeof(double) * m);
+    double *g = arenaAloca(sizeof(double) * (m + 1));
+    double *xd = arenaAloca(sizeof(double) * n);
+    double *z = arenaAloca(sizeof(double) * n);
+    double *w = arenaAloca(sizeof(double) * n);
+
+    double bnorma = 0.0;
+    for (i = 0; i < n; i++)
+        bnorma += (double) SL->b[i] * SL->b[i];
+    double tol = SL->erro * sqrt(bnorma);
+
+    for (i = 0; i < n; i++)
+        xd[i] = x[i];
+
+    int iter = 0, erro = 0;
+    for (;;){
+        // r = b - Ax
+        multiplicaCSR(SL, xd, w, paralelo);
+        for (i = 0; i < n; i++)
+            V[i] = SL->b[i] - w[i];
+        double beta = sqrt(produtoDuplo(V, V, n));
+
+        if (beta <= tol)
+            break;
+        if (iter >= MAXIT_GMRES){
+            erro = -1;
+            break;
+        }
+
+        for (i = 0; i < n; i++)
+            V[i] /= beta;
+        g[0] = beta;
+
+        // Arnoldi com Gram-Schmidt modificado
+        for (j = 0; j < m && iter < MAXIT_GMRES; ){
+            double *vj = V + (size_t) j * n, *vn = vj + n;
+
+            aplicaILU(M, n, vj, z);
+            multiplicaCSR(SL, z, w, paralelo);
+            INSTR_INICIO(FASE_VETORES);
+            for (k = 0; k <= j; k++){
+                double h = produtoDuplo(w, V + (size_t) k * n, n);
+                H[k * m + j] = h;
+                for (i = 0; i < n; i++)
+                    w[i] -= h * V[(size_t) k * n + i];
+            }
+            double h = sqrt(produtoDuplo(w, w, n));
+            H[(j + 1) * m + j] = h;
+            if (h != 0.0)
+                for (i = 0; i < n; i++)
+                    vn[i] = w[i] / h;
+            INSTR_FIM(FASE_VETORES);
+
+            // Rotações anteriores na nova coluna e a que anula H[j+1][j]
+            for (k = 0; k < j; k++){
+                double a = H[k * m + j], b = H[(k + 1) * m + j];
+                H[k * m + j] = cs[k] * a + sn[k] * b;
+                H[(k + 1) * m + j] = -sn[k] * a + cs[k] * b;
+            }
+            double a = H[j * m + j], r = hypot(a, h);
+            cs[j] = a / r;
+            sn[j] = h / r;
+            H[j * m + j] = r;
+            H[(j + 1) * m + j] = 0.0;
+            g[j + 1] = -sn[j] * g[j];
+            g[j] = cs[j] * g[j];
+
+            j++;
+            iter++;
+            if (fabs(g[j]) <= tol || h == 0.0)
+                break;
+        }
+
+        // y = H^-1 g (triangular superior) e x += M^-1 (V y)
+        for (k = j; k-- > 0; ){
+            double sum = g[k];
+            for (i = k + 1; i < j; i++)
+                sum -= H[k * m + i] * g[i];
+            g[k] = sum / H[k * m + k];
+        }
+        for (i = 0; i < n; i++){
+            double sum = 0.0;
+            for (k = 0; k < j; k++)
+                sum += g[k] * V[(size_t) k * n + i];
+            w[i] = sum;
+        }
+        aplicaILU(M, n, w, z);
+        for (i = 0; i < n; i++)
+            xd[i] += z[i];
+
+        if (!isfinite(produtoDuplo(xd, xd, n))){
+            erro = -3;
+            break;
+        }
+    }
+
+    *tTotal = timestamp() - time;
+    if (erro)
+        fprintf(stderr, erro == -1 ? "GMRES doesn't converge.\n" : "GMRES floating point error.\n");
+    else
+        for (i = 0; i < n; i++)
+            x[i] = (real_t) xd[i];
+
+    arenaRetorna(marca);
+
+    return erro ? erro : iter;
+}
+
+
+/*!
+  \brief Método GMRES para SL denso, resolvido na forma CSR
+
+  \param SL Ponteiro para o sistema linear
+  \param x ponteiro para o vetor solução. Ao iniciar função contém
+            valor inicial
+  \param tTotal time gasto pelo método, incluindo a conversão
+
+  \return o mesmo que gmresCSR
+  */
+int gmres (SistLinear_t *SL, real_t *x, double *tTotal)
+{
+    double time = timestamp();
+
+    SistLinearCSR_t *CSR = densoParaCSR(SL);
+    int result = gmresCSR(CSR, x, tTotal);
+    liberaSistLinearCSR(CSR);
+
+    *tTotal = timestamp() - time;
+    return result;
+}
@@ -0,0 +1,53 @@
+#ifndef __SISESPARSOS_H__
+#define __SISESPARSOS_H__
+
+#include "SistemasLineares.h"
+
+#define GMRES_M 30  // Dimensão do subespaço de Krylov antes de cada reinício do GMRES
+#define MAXIT_GMRES 1000  // Número máximo de iterações (produtos por A) do GMRES
+
+// Sistema linear esparso em formato CSR (Compressed Sparse Row)
+typedef struct {
+  unsigned int n; // tamanho do SL
+  unsigned int nnz; // número de coeficientes não nulos
+  real_t erro; // critério de parada
+  real_t *val; // coeficientes não nulos, linha a linha
+  unsigned int *col; // coluna de cada coeficiente em 'val'
+  unsigned int *lin; // coeficientes da linha i estão em val[lin[i]] .. val[lin[i+1]-1]
+  real_t *b; // termos independentes
+} SistLinearCSR_t;
+
+// Alocaçao e desalocação de memória
+SistLinearCSR_t *alocaSistLinearCSR (unsigned int n, unsigned int nnz);
+void liberaSistLinearCSR (SistLinearCSR_t *SL);
+
+// Conversão a partir de um SL denso
+SistLinearCSR_t *densoParaCSR (SistLinear_t *SL);
+
+// Leitura de SL esparso: "n nnz", erro, nnz triplas "i j valor" (base 0) e b
+SistLinearCSR_t *lerSistLinearCSR ();
+
+// Calcula o resíduo de um sistema linear esparso e sua solução
+void residueCSR (SistLinearCSR_t *SL, real_t *x, real_t *res);
+
+// Retorna a normaL2 do resíduo. Parâmetro 'res' deve ter o resíduo.
+real_t normaL2ResiduoCSR (SistLinearCSR_t *SL, real_t *res);
+
+// Critérios de convergência de Gauss-Jacobi e Gauss-Seidel
+int jacobi_convergeCSR (SistLinearCSR_t *SL);
+int seidel_convergeCSR (SistLinearCSR_t *SL);
+
+// Método de Jacobi. Valor inicial e resultado no parâmetro 'x'
+int gaussJacobiCSR (SistLinearCSR_t *SL, real_t *x, double *tTotal);
+
+// Método de Gauss-Seidel. Valor inicial e resultado no parâmetro 'x'
+int gaussSeidelCSR (SistLinearCSR_t *SL, real_t *x, double *tTotal);
+
+// Método GMRES(GMRES_M) com reinício e precondicionador ILU(0), para matrizes
+// não simétricas. Valor inicial e resultado no parâmetro 'x'
+int gmresCSR (SistLinearCSR_t *SL, real_t *x, double *tTotal);
+
+// GMRES para SL denso, convertido para CSR
+int gmres (SistLinear_t *SL, real_t *x, double *tTotal);
+
+#endif // __SISESPARSOS_H__
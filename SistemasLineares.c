@@ -3,9 +3,19 @@
 #include <stdlib.h>
 #include <string.h>
 #include <float.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "utils.h"
+#include "arena.h"
+#include "simd.h"
 #include "SistemasLineares.h"
+#include "SistemasPequenos.h"
+#include "SistemasBanda.h"
+#include "cacheLU.h"
+#include "arquivos.h"
+#include "instrumenta.h"
 
 
 /*!
@@ -19,88 +29,410 @@
 */
 real_t normaL2Residuo(SistLinear_t *SL, real_t *x, real_t *res)
 {
-    real_t sum = 0.0f;
-    for (int i = 0; i < SL->n; i++)
-        sum += pow(res[i], 2.0f); 
-    return sqrt(sum);
+    return sqrt(somaQuadrados(res, SL->n));
 }
 
 
-/*!
-  \brief Método da Eliminação de Gauss
+// Fatora o painel de colunas [kb, kb+nb) a partir da linha kb. As trocas de
+// linhas ficam restritas ao painel e são registradas em 'ipiv'. Valores
+// inválidos são procurados uma única vez por linha do painel, ao final
+static int lu_painel (real_t *A, unsigned int n, unsigned int lda, unsigned int kb, unsigned int nb, unsigned int *ipiv)
+{
+    unsigned int i, k, j, fim = kb + nb;
+    real_t m;
 
-  \param SL Ponteiro para o sistema linear
-  \param x ponteiro para o vetor solução
-  \param tTotal time gasto pelo método
+    for (k = kb; k < fim; k++){
+        real_t *Ak = A + k * lda;
 
-  \return código de erro. 0 em caso de sucesso.
-*/
-int eliminacaoGauss (SistLinear_t *SL, real_t *x, double *tTotal)
-{
-    SistLinear_t *clone = copiar_SL(SL);
-    int i, k, j, result;
-    double m, time = timestamp();
-    
-    // Triangula usando o pivoteamento parcial
-    for (k = 0; k < clone->n - 1; k++){
+        // Pivoteamento parcial
+        INSTR_INICIO(FASE_PIVO);
         unsigned int max_index = k;
-        float max = fabs(clone->A[k][k]);
-        for (i = k + 1; i < clone->n; i++)
-            if (fabs(clone->A[i][k]) > max)
+        real_t max = fabs(Ak[k]);
+        for (i = k + 1; i < n; i++)
+            if (fabs(A[i * lda + k]) > max){
+                max = fabs(A[i * lda + k]);
                 max_index = i;
+            }
+        INSTR_FIM(FASE_PIVO);
+
+        if (max == 0.0f){
+            fprintf(stderr, "Gauss-Jordan floating point error.\n");
+            return -1;
+        }
 
+        ipiv[k] = max_index;
         if (max_index != k){ // Se terminou em um índice diferente de onde começou, troca
-            real_t aux;
-            for (int c = 0; c < SL->n; c++){
-                aux = clone->A[k][c];
-                clone->A[k][c] = clone->A[max_index][c];
-                clone->A[max_index][c] = aux;
+            INSTR_INICIO(FASE_TROCA);
+            real_t aux, *Am = A + max_index * lda;
+            for (j = kb; j < fim; j++){
+                aux = Ak[j];
+                Ak[j] = Am[j];
+                Am[j] = aux;
             }
+            INSTR_FIM(FASE_TROCA);
+        }
+
+        // Guarda os multiplicadores abaixo da diagonal (L)
+        INSTR_INICIO(FASE_ELIMINACAO);
+        for (i = k + 1; i < n; i++){
+            real_t *Ai = A + i * lda;
+            m = Ai[k] / Ak[k];
 
-            aux = clone->b[k];
-            clone->b[k] = clone->b[max_index];
-            clone->b[max_index] = aux;
+            Ai[k] = m;
+            for (j = k + 1; j < fim; j++)
+                Ai[j] -= m * Ak[j];
         }
+        INSTR_FIM(FASE_ELIMINACAO);
+    }
 
-        for (i = k + 1; i < clone->n; i++){
-            m = clone->A[i][k] / clone->A[k][k];
-            if (invalid(m)){
-                fprintf(stderr, "Gauss-Jordan floating point error.\n");
-                liberaSistLinear(clone);
-                return -1;
+    // Inclui valores que chegaram inválidos da atualização dos painéis anteriores
+    for (i = kb; i < n; i++)
+        if (vetor_invalido(A + i * lda + kb, nb)){
+            fprintf(stderr, "Gauss-Jordan floating point error.\n");
+            return -1;
+        }
+
+    return 0;
+}
+
+
+// Aplica nas colunas [j0, j1) as trocas de linhas do painel kb
+static void lu_troca (real_t *A, unsigned int n, unsigned int lda, unsigned int kb, unsigned int nb,
+                      unsigned int *ipiv, unsigned int j0, unsigned int j1)
+{
+    real_t aux, *Ak, *Am;
+    for (unsigned int k = kb; k < kb + nb; k++)
+        if (ipiv[k] != k){
+            Ak = A + k * lda;
+            Am = A + ipiv[k] * lda;
+            for (unsigned int j = j0; j < j1; j++){
+                aux = Ak[j];
+                Ak[j] = Am[j];
+                Am[j] = aux;
             }
+        }
+}
 
-            clone->A[i][k] = 0.0f;
-            for (j = k + 1; j < clone->n; j++){
-                clone->A[i][j] -= (m * clone->A[k][j]);
-                if (invalid(clone->A[i][j])){
-                    fprintf(stderr, "Gauss-Jordan floating point error.\n");
-                    liberaSistLinear(clone);
-                    return -1;
-                }
+
+// Atualiza as colunas [j0, j1) à direita do painel kb: troca de linhas,
+// U12 = L11^-1 * A12 e A22 -= L21 * U12
+static void lu_atualiza (real_t *A, unsigned int n, unsigned int lda, unsigned int kb, unsigned int nb,
+                         unsigned int *ipiv, unsigned int j0, unsigned int j1)
+{
+    unsigned int i, l, j, fim = kb + nb;
+
+    INSTR_INICIO(FASE_TROCA);
+    lu_troca(A, n, lda, kb, nb, ipiv, j0, j1);
+    INSTR_FIM(FASE_TROCA);
+
+    // Bloco de U à direita do painel
+    INSTR_INICIO(FASE_ELIMINACAO);
+    for (i = kb + 1; i < fim; i++){
+        real_t *Ai = A + i * lda;
+        for (l = kb; l < i; l++){
+            real_t m = Ai[l], *Ul = A + l * lda;
+            for (j = j0; j < j1; j++)
+                Ai[j] -= m * Ul[j];
+        }
+    }
+
+    // Restante da matriz, quatro linhas por vez para reaproveitar cada linha de U12
+    for (i = fim; i + 4 <= n; i += 4){
+        real_t *A0 = A + i * lda, *A1 = A0 + lda, *A2 = A1 + lda, *A3 = A2 + lda;
+        for (l = kb; l < fim; l++){
+            real_t m0 = A0[l], m1 = A1[l], m2 = A2[l], m3 = A3[l], *Ul = A + l * lda;
+            for (j = j0; j < j1; j++){
+                real_t u = Ul[j];
+                A0[j] -= m0 * u;
+                A1[j] -= m1 * u;
+                A2[j] -= m2 * u;
+                A3[j] -= m3 * u;
+            }
+        }
+    }
+    for (; i < n; i++){
+        real_t *Ai = A + i * lda;
+        for (l = kb; l < fim; l++){
+            real_t m = Ai[l], *Ul = A + l * lda;
+            for (j = j0; j < j1; j++)
+                Ai[j] -= m * Ul[j];
+        }
+    }
+    INSTR_FIM(FASE_ELIMINACAO);
+}
+
+
+// Fatoração blocada com um painel/bloco de colunas por tarefa. Cada bloco de
+// LU_BLOCO colunas tem um marcador de dependência: o painel k espera as
+// atualizações anteriores do seu bloco e cada atualização do bloco j espera o
+// painel k. A sequência de operações em cada elemento é a mesma da versão
+// serial, logo o resultado é idêntico
+static int lu_tarefas (real_t *A, unsigned int n, unsigned int lda, unsigned int *ipiv)
+{
+    unsigned int nblocos = (n + LU_BLOCO - 1) / LU_BLOCO;
+    int erro = 0;
+
+    MarcaArena_t marca = arenaMarca();
+    char *dep = arenaAloca(nblocos);
+    (void) dep; // só aparece nas cláusulas depend, que -Wunused-variable não considera
+
+    #pragma omp parallel
+    #pragma omp single
+    for (unsigned int K = 0; K < nblocos; K++){
+        unsigned int kb = K * LU_BLOCO;
+        unsigned int nb = (n - kb < LU_BLOCO) ? n - kb : LU_BLOCO;
+
+        #pragma omp task depend(inout: dep[K]) shared(erro)
+        {
+            int falhou;
+            #pragma omp atomic read
+            falhou = erro;
+            if (!falhou && lu_painel(A, n, lda, kb, nb, ipiv)){
+                #pragma omp atomic write
+                erro = 1;
+            }
+        }
+
+        for (unsigned int J = K + 1; J < nblocos; J++){
+            unsigned int j0 = J * LU_BLOCO;
+            unsigned int j1 = (n - j0 < LU_BLOCO) ? n : j0 + LU_BLOCO;
+
+            #pragma omp task depend(in: dep[K]) depend(inout: dep[J]) shared(erro)
+            {
+                int falhou;
+                #pragma omp atomic read
+                falhou = erro;
+                if (!falhou)
+                    lu_atualiza(A, n, lda, kb, nb, ipiv, j0, j1);
             }
-                
-            clone->b[i] -= m * clone->b[k];
-            if (invalid(clone->b[i])){
-                fprintf(stderr, "Gauss-Jordan floating point error.\n");
-                liberaSistLinear(clone);
+        }
+    }
+
+    arenaRetorna(marca);
+
+    return erro ? -1 : 0;
+}
+
+
+/*!
+  \brief Fatoração LU com pivoteamento parcial
+
+  Versão blocada (right-looking): cada painel de LU_BLOCO colunas é fatorado
+  e o restante da matriz é atualizado em faixas de LU_FAIXA colunas, para que
+  o bloco de U reutilizado caiba em cache. Com mais de uma thread e
+  n >= LU_PARALELO, painéis e atualizações viram tarefas OpenMP.
+
+  \param SL Ponteiro para o sistema linear
+  \param LU Fatoração de mesmo tamanho que SL. Ao final contém L, U e a
+            permutação das linhas
+
+  \return código de erro. 0 em caso de sucesso.
+*/
+int fatoraLU (SistLinear_t *SL, FatorLU_t *LU)
+{
+    real_t *A = LU->LU[0];
+    unsigned int n = SL->n, lda = LU->lda, kb, nb, j0, k, aux;
+
+    if (SL->lda == lda)
+        memcpy(A, SL->A[0], sizeof(real_t) * n * lda);
+    else
+        for (k = 0; k < n; k++)
+            memcpy(LU->LU[k], SL->A[k], sizeof(real_t) * n);
+
+    MarcaArena_t marca = arenaMarca();
+    unsigned int *ipiv = arenaAloca(n * sizeof(unsigned int));
+
+    if (numThreads() > 1 && n >= LU_PARALELO){
+        if (lu_tarefas(A, n, lda, ipiv)){
+            arenaRetorna(marca);
+            return -1;
+        }
+    }
+    else
+        for (kb = 0; kb < n; kb += LU_BLOCO){
+            nb = (n - kb < LU_BLOCO) ? n - kb : LU_BLOCO;
+            if (lu_painel(A, n, lda, kb, nb, ipiv)){
+                arenaRetorna(marca);
                 return -1;
             }
+
+            for (j0 = kb + nb; j0 < n; j0 += LU_FAIXA)
+                lu_atualiza(A, n, lda, kb, nb, ipiv, j0, (n - j0 < LU_FAIXA) ? n : j0 + LU_FAIXA);
         }
+
+    // Trocas de linha nas colunas de L à esquerda de cada painel
+    INSTR_INICIO(FASE_TROCA);
+    for (kb = LU_BLOCO; kb < n; kb += LU_BLOCO){
+        nb = (n - kb < LU_BLOCO) ? n - kb : LU_BLOCO;
+        lu_troca(A, n, lda, kb, nb, ipiv, 0, kb);
+    }
+    INSTR_FIM(FASE_TROCA);
+
+    for (k = 0; k < n; k++)
+        LU->p[k] = k;
+    for (k = 0; k < n; k++){
+        aux = LU->p[k];
+        LU->p[k] = LU->p[ipiv[k]];
+        LU->p[ipiv[k]] = aux;
     }
 
-    result = retrosubs(clone);
-    if (result){
-        liberaSistLinear(clone);
+    arenaRetorna(marca);
+
+    return 0;
+}
+
+
+/*!
+  \brief Resolve um sistema a partir de sua fatoração LU
+
+  \param LU Ponteiro para a fatoração
+  \param b termos independentes
+  \param x ponteiro para o vetor solução. Não pode ser o mesmo que 'b'
+
+  \return código de erro. 0 em caso de sucesso.
+*/
+int luSolve (FatorLU_t *LU, real_t *b, real_t *x)
+{
+    real_t **A = LU->LU;
+    double sum;
+
+    // Ly = Pb
+    INSTR_INICIO(FASE_SUBSTITUICAO);
+    for (int i = 0; i < LU->n; i++){
+        sum = b[LU->p[i]];
+        for (int j = 0; j < i; j++)
+            sum -= A[i][j] * x[j];
+        x[i] = sum;
+    }
+    INSTR_FIM(FASE_SUBSTITUICAO);
+
+    // Ux = y
+    return retrosubs(LU, x);
+}
+
+
+/*  Solução triangular com várias colunas (TRSM). As colunas são resolvidas em
+    faixas de RHS_BLOCO, guardadas linha a linha em W: cada elemento de L e U é
+    lido uma única vez por faixa e aplicado a todas as suas colunas, num laço
+    contíguo que o compilador vetoriza, em vez de k passadas completas sobre a
+    matriz. W é double, como os acumuladores de luSolve
+*/
+int luSolveMultiplo (FatorLU_t *LU, real_t *B, real_t *X, unsigned int k)
+{
+    real_t **A = LU->LU;
+    unsigned int n = LU->n, i, j, c, c0, kb;
+    MarcaArena_t marca = arenaMarca();
+    double *W = arenaAloca(sizeof(double) * n * RHS_BLOCO);
+
+    INSTR_INICIO(FASE_SUBSTITUICAO);
+
+    for (c0 = 0; c0 < k; c0 += RHS_BLOCO){
+        kb = (k - c0 < RHS_BLOCO) ? k - c0 : RHS_BLOCO;
+
+        // LY = PB
+        for (i = 0; i < n; i++){
+            double *wi = W + (size_t) i * kb;
+            for (c = 0; c < kb; c++)
+                wi[c] = B[(size_t) (c0 + c) * n + LU->p[i]];
+            for (j = 0; j < i; j++){
+                const double l = A[i][j];
+                const double *wj = W + (size_t) j * kb;
+                for (c = 0; c < kb; c++)
+                    wi[c] -= l * wj[c];
+            }
+        }
+
+        // UX = Y
+        for (i = n; i-- > 0; ){
+            double *wi = W + (size_t) i * kb;
+            for (j = i + 1; j < n; j++){
+                const double u = A[i][j];
+                const double *wj = W + (size_t) j * kb;
+                for (c = 0; c < kb; c++)
+                    wi[c] -= u * wj[c];
+            }
+            const double d = A[i][i];
+            for (c = 0; c < kb; c++)
+                wi[c] /= d;
+        }
+
+        for (c = 0; c < kb; c++)
+            for (i = 0; i < n; i++)
+                X[(size_t) (c0 + c) * n + i] = W[(size_t) i * kb + c];
+    }
+    INSTR_FIM(FASE_SUBSTITUICAO);
+    arenaRetorna(marca);
+
+    if (vetor_invalido(X, n * k)){
+        fprintf(stderr, "Retrosubs floating point failure.\n");
         return -1;
     }
+    return 0;
+}
+
+
+/*!
+  \brief Método da Eliminação de Gauss
+
+  \param SL Ponteiro para o sistema linear
+  \param x ponteiro para o vetor solução
+  \param tTotal time gasto pelo método
+
+  \return código de erro. 0 em caso de sucesso.
+*/
+int eliminacaoGauss (SistLinear_t *SL, real_t *x, double *tTotal)
+{
+    // Com o cache ativo, sistemas pequenos passam por ele: a dispersão de até
+    // PEQUENO_MAX² coeficientes é barata e um acerto dispensa a fatoração. Os
+    // em banda não, pois a dispersão de A (n²) custa mais que a fatoração em banda
+    if (SL_PEQUENO(SL) && !cacheLUAtivo()){
+        double time = timestamp();
+        int result = eliminacaoGaussPequeno(SL, x);
+        *tTotal = timestamp() - time;
+        return result;
+    }
+
+    if (SL_BANDA(SL)){
+        double time = timestamp();
+        int result = eliminacaoGaussBanda(SL, x);
+        *tTotal = timestamp() - time;
+        return result;
+    }
+
+    double time = timestamp();
+
+    EntradaLU_t *E = obtemFatorLU(SL, 1);
+    int result = E ? luSolve(E->LU, SL->b, x) : -1;
 
     *tTotal = timestamp() - time;
-    memcpy(x, clone->b, sizeof(real_t) * clone->n);
+    if (E)
+        devolveFatorLU(E);
 
-    liberaSistLinear(clone);
+    return result ? -1 : 0;
+}
 
-    return 0;
+
+/*!
+  \brief Método da Eliminação de Gauss com várias colunas de termos independentes
+
+  \param SL Ponteiro para o sistema linear
+  \param X ponteiro para as soluções (n x SL->nrhs, coluna a coluna)
+  \param tTotal time gasto pelo método
+
+  \return código de erro. 0 em caso de sucesso.
+*/
+int eliminacaoGaussMultiplo (SistLinear_t *SL, real_t *X, double *tTotal)
+{
+    double time = timestamp();
+
+    EntradaLU_t *E = obtemFatorLU(SL, 1);
+    int result = E ? luSolveMultiplo(E->LU, SL->b, X, SL->nrhs) : -1;
+
+    *tTotal = timestamp() - time;
+    if (E)
+        devolveFatorLU(E);
+
+    return result ? -1 : 0;
 }
 
 
@@ -122,62 +454,69 @@ int gaussJacobi (SistLinear_t *SL, real_t *x, double *tTotal)
         fprintf(stderr, "Gauss-Jacobi doesn't converge.\n");
         return -1;
     }
-        
-    real_t* curr_iter = calloc(SL->n, sizeof(real_t)); // Valores usados na atual iteração
-    must_alloc(curr_iter, __func__);
-
-    real_t* next_iter = malloc(SL->n * sizeof(real_t)); // Valores a serem usados na próxima iteração
-    must_alloc(next_iter, __func__);
-    for (int i = 0; i < SL->n; i++) next_iter[i] = FLT_MAX; // Inicia o vetor com valores muito diferentes da primeira iteração
-
-    real_t* aux_iter = calloc(SL->n, sizeof(real_t)); // Vetor auxiliar para conservar os valores a serem comparados entre iterações
-    must_alloc(aux_iter, __func__);
 
-    void **ptrs = malloc(sizeof(void*) * 3);
-    ptrs[0] = curr_iter;
-    ptrs[1] = next_iter; 
-    ptrs[2] = aux_iter;
+    if (SL_PEQUENO(SL)){
+        double time = timestamp();
+        int result = gaussJacobiPequeno(SL, x);
+        *tTotal = timestamp() - time;
+        return result;
+    }
+        
+    MarcaArena_t marca = arenaMarca();
+    real_t* curr_iter = arenaAloca(SL->n * sizeof(real_t)); // Valores usados na atual iteração
+    real_t* next_iter = arenaAloca(SL->n * sizeof(real_t)); // Valores calculados na atual iteração
+    memcpy(curr_iter, x, sizeof(real_t) * SL->n);
 
-    real_t prev_diff = FLT_MAX; // A maior diferença entre as iterações
+    real_t diff = FLT_MAX; // A maior diferença entre as iterações
+    int erro = 0, paralelo = numThreads() > 1 && SL->n >= ITER_PARALELO;
 
-    int iter, i, k;
-    double sum, time = timestamp();
+    int iter, i;
+    double time = timestamp();
     // Enquanto forem muito diferentes e iter não ultrapassou o limite de iterações, itera
-    for (iter = 0; iter < MAXIT && too_different(curr_iter, next_iter, SL->n, SL->erro); iter++){
-        memcpy(curr_iter, aux_iter, sizeof(real_t) * SL->n);
+    for (iter = 0; iter < MAXIT && diff > SL->erro; iter++){
+        diff = 0.0f;
+
+        // Cada linha é independente; a maior diferença é reduzida junto da varredura
+        INSTR_INICIO(FASE_VARREDURA);
+        #pragma omp parallel for reduction(max: diff) if(paralelo)
         for (i = 0; i < SL->n; i++){
-            sum = 0.0f;
-            for (k = 0; k < SL->n; k++){
-                if (k != i) // Impede que some o pivô
-                    sum += SL->A[i][k] * curr_iter[k];
-                if (invalid(sum)){
-                    fprintf(stderr, "Gauss-Jacobi floating point error.\n");
-                    free_these(ptrs, 3);
-                    return -3;
-                }
-            }
+            // Soma a linha inteira e retira o pivô, sem desvio no laço interno
+            double sum = produtoInterno(SL->A[i], curr_iter, SL->n) - (double) SL->A[i][i] * curr_iter[i];
 
             if (SL->A[i][i] == 0.0f && (SL->b[i] - sum) != 0.0f){
-                fprintf(stderr, "Gauss-Jacobi no solution.\n");
-                free_these(ptrs, 3);
-                return -2;
+                #pragma omp atomic write
+                erro = -2;
+                continue;
             }
-            else
-                next_iter[i] = (SL->b[i] - sum) / SL->A[i][i];
+            next_iter[i] = (SL->b[i] - sum) / SL->A[i][i];
 
-            if (invalid(next_iter[i])){
-                fprintf(stderr, "Gauss-Jacobi floating point error.\n");
-                free_these(ptrs, 3);
-                return -3;
-            }
+            real_t d = fabs(next_iter[i] - curr_iter[i]);
+            if (d > diff)
+                diff = d;
         }
-        memcpy(aux_iter, next_iter, sizeof(real_t) * SL->n);
+        INSTR_FIM(FASE_VARREDURA);
+
+        INSTR_INICIO(FASE_CONVERGENCIA);
+        if (!erro && vetor_invalido(next_iter, SL->n))
+            erro = -3;
+        INSTR_FIM(FASE_CONVERGENCIA);
+
+        if (erro){
+            fprintf(stderr, erro == -2 ? "Gauss-Jacobi no solution.\n" : "Gauss-Jacobi floating point error.\n");
+            arenaRetorna(marca);
+            return erro;
+        }
+
+        // A iteração calculada passa a ser a atual, sem cópias
+        real_t *aux = curr_iter;
+        curr_iter = next_iter;
+        next_iter = aux;
     }
 
     *tTotal = timestamp() - time;
-    memcpy(x, next_iter, sizeof(real_t) * SL->n);
+    memcpy(x, curr_iter, sizeof(real_t) * SL->n);
     
-    free_these(ptrs, 3);
+    arenaRetorna(marca);
 
     return iter;
 }
@@ -202,61 +541,476 @@ int gaussSeidel (SistLinear_t *SL, real_t *x, double *tTotal)
         return -1;
     }
 
-    real_t* prev_iter = malloc(SL->n * sizeof(real_t)); // Valores da iteração anterior
-    must_alloc(prev_iter, __func__);
-    for (int i = 0; i < SL->n; i++) prev_iter[i] = FLT_MAX; // Inicia o vetor com valores muito diferentes da primeira iteração
+    if (SL_PEQUENO(SL)){
+        double time = timestamp();
+        int result = gaussSeidelPequeno(SL, x);
+        *tTotal = timestamp() - time;
+        return result;
+    }
 
-    real_t* curr_iter = calloc(SL->n, sizeof(real_t)); // Valores da iteração atual
-    must_alloc(curr_iter, __func__);
+    MarcaArena_t marca = arenaMarca();
+    real_t* prev_iter = arenaAloca(SL->n * sizeof(real_t)); // Valores da iteração anterior
+    for (int i = 0; i < SL->n; i++) prev_iter[i] = FLT_MAX; // Inicia o vetor com valores muito diferentes da primeira iteração
 
-    void **ptrs = malloc(sizeof(void*) * 2);
-    ptrs[0] = prev_iter;
-    ptrs[1] = curr_iter; 
+    real_t* curr_iter = arenaAloca(SL->n * sizeof(real_t)); // Valores da iteração atual
+    memcpy(curr_iter, x, sizeof(real_t) * SL->n);
 
     real_t prev_diff = FLT_MAX; // A maior diferença entre as iterações
 
-    int iter, i, k;
+    int iter, i;
     double sum, time = timestamp();
     // Enquanto forem muito diferentes e iter não ultrapassou o limite de iterações, itera
     for (iter = 0; iter < MAXIT && too_different(prev_iter, curr_iter, SL->n, SL->erro); iter++){
+        INSTR_INICIO(FASE_COPIA);
         memcpy(prev_iter, curr_iter, sizeof(real_t) * SL->n);
+        INSTR_FIM(FASE_COPIA);
+
+        INSTR_INICIO(FASE_VARREDURA);
         for (i = 0; i < SL->n; i++){
-            sum = 0.0f;
-            for (k = 0; k < SL->n; k++){
-                if (k != i)
-                    sum += SL->A[i][k] * curr_iter[k];
-                if (invalid(sum)){
-                    fprintf(stderr, "Gauss-Seidel floating point error.\n");
-                    free_these(ptrs, 2);
-                    return -3;
-                }
-            }
+            sum = produtoInterno(SL->A[i], curr_iter, SL->n) - (double) SL->A[i][i] * curr_iter[i];
 
             if (SL->A[i][i] == 0.0f && (SL->b[i] != 0.0f)){
+                INSTR_FIM(FASE_VARREDURA);
                 fprintf(stderr, "No solution.\n");
-                free_these(ptrs, 2);
+                arenaRetorna(marca);
                 return -2;
             }
             else
                 curr_iter[i] = (SL->b[i] - sum) / SL->A[i][i];
+        }
+        INSTR_FIM(FASE_VARREDURA);
+
+        // Um valor inválido contamina as linhas seguintes; basta verificar ao fim da varredura
+        INSTR_INICIO(FASE_CONVERGENCIA);
+        int invalido = vetor_invalido(curr_iter, SL->n);
+        INSTR_FIM(FASE_CONVERGENCIA);
+        if (invalido){
+            fprintf(stderr, "Gauss-Seidel floating point error.\n");
+            arenaRetorna(marca);
+            return -3;
+        }
+    }
+
+    *tTotal = timestamp() - time;
+    memcpy(x, curr_iter, sizeof(real_t) * SL->n);
+
+    arenaRetorna(marca);
+
+    return iter;
+}
+
+
+// Atualiza a linha i de x pela relaxação de Gauss-Seidel. Retorna a variação
+// de x[i]; com pivô nulo e b[i] não nulo, marca 'erro' (-2) e não altera x[i]
+static inline real_t atualizaLinhaSOR (SistLinear_t *SL, real_t *x, unsigned int i, real_t omega, int *erro)
+{
+    if (SL->A[i][i] == 0.0f && (SL->b[i] != 0.0f)){
+        #pragma omp atomic write
+        *erro = -2;
+        return 0.0f;
+    }
+
+    double sum = produtoInterno(SL->A[i], x, SL->n) - (double) SL->A[i][i] * x[i];
+    real_t novo = (1.0f - omega) * x[i] + omega * (SL->b[i] - sum) / SL->A[i][i];
+
+    real_t d = fabs(novo - x[i]);
+    x[i] = novo;
+    return d;
+}
+
+
+/*!
+  \brief Método de Gauss-Seidel multicolorido com relaxação (SOR)
+
+  As linhas são coloridas de forma que linhas de mesma cor não dependam
+  entre si; cada cor é então atualizada em paralelo, na ordem das cores.
+  Se há mais cores que n/2, as linhas são varridas em sequência.
 
-            if (invalid(curr_iter[i])){
-                fprintf(stderr, "Gauss-Seidel floating point error.\n");
-                free_these(ptrs, 2);
-                return -3;
+  \param SL Ponteiro para o sistema linear
+  \param x ponteiro para o vetor solução. Ao iniciar função contém
+            valor inicial
+  \param omega fator de relaxação, em (0, 2). 1 equivale a Gauss-Seidel. A
+            dominância diagonal só garante convergência para omega <= 1;
+            acima disso o método pode divergir ou parar em MAXIT iterações
+  \param tTotal time gasto pelo método
+
+  \return código de erro. Um nr positivo indica sucesso e o nr
+          de iterações realizadas. Um nr. negativo indica um erro:
+          -1 (não converge) -2 (sem solução)
+  */
+int gaussSeidelMulticor (SistLinear_t *SL, real_t *x, real_t omega, double *tTotal)
+{
+    // O critério das linhas independe da ordem de varredura, mas só garante a
+    // convergência com omega <= 1 (sub-relaxação ou Gauss-Seidel)
+    if (omega <= 0.0f || omega >= 2.0f || !jacobi_converge(SL)){
+        fprintf(stderr, "Gauss-Seidel doesn't converge.\n");
+        return -1;
+    }
+
+    MarcaArena_t marca = arenaMarca();
+    real_t* curr_iter = arenaAloca(SL->n * sizeof(real_t)); // Valores da iteração atual
+    memcpy(curr_iter, x, sizeof(real_t) * SL->n);
+
+    double time = timestamp();
+    Coloracao_t *C = coloreSistLinear(SL);
+
+    real_t diff = FLT_MAX; // A maior diferença entre as iterações
+    int erro = 0, paralelo = numThreads() > 1 && SL->n >= ITER_PARALELO;
+    // Com quase uma cor por linha (matrizes densas) cada cor abriria uma região
+    // paralela para uma ou duas linhas: varre as linhas em sequência, como SOR comum
+    int sequencial = C->ncores > SL->n / 2;
+
+    int iter, c, r;
+    for (iter = 0; iter < MAXIT && diff > SL->erro; iter++){
+        diff = 0.0f;
+        INSTR_INICIO(FASE_VARREDURA);
+        if (sequencial)
+            for (r = 0; r < SL->n; r++){
+                real_t d = atualizaLinhaSOR(SL, curr_iter, r, omega, &erro);
+                if (d > diff)
+                    diff = d;
             }
+        else
+            for (c = 0; c < C->ncores; c++){
+                #pragma omp parallel for reduction(max: diff) if(paralelo)
+                for (r = C->inicio[c]; r < C->inicio[c + 1]; r++){
+                    real_t d = atualizaLinhaSOR(SL, curr_iter, C->ordem[r], omega, &erro);
+                    if (d > diff)
+                        diff = d;
+                }
+            }
+        INSTR_FIM(FASE_VARREDURA);
+
+        INSTR_INICIO(FASE_CONVERGENCIA);
+        if (!erro && vetor_invalido(curr_iter, SL->n))
+            erro = -3;
+        INSTR_FIM(FASE_CONVERGENCIA);
+
+        if (erro){
+            fprintf(stderr, erro == -2 ? "No solution.\n" : "Gauss-Seidel floating point error.\n");
+            liberaColoracao(C);
+            arenaRetorna(marca);
+            return erro;
         }
     }
 
     *tTotal = timestamp() - time;
     memcpy(x, curr_iter, sizeof(real_t) * SL->n);
 
-    free_these(ptrs, 2);
+    liberaColoracao(C);
+    arenaRetorna(marca);
 
     return iter;
 }
 
 
+// Fator incompleto de Cholesky: L triangular inferior (diagonal por último
+// em cada linha) restrito ao padrão de A, guardado linha a linha
+typedef struct {
+    real_t *val;
+    unsigned int *col, *lin;
+} FatorIC_t;
+
+
+/*  IC(0): L[i][k] = (a_ik - soma_j L[i][j]L[k][j]) / L[k][k], apenas onde a_ik != 0.
+    A soma percorre as duas linhas já calculadas, intercalando as colunas.
+    O fator fica na área de trabalho do chamador.
+    Retorna NULL se algum pivô não for positivo (A não é SPD ou IC(0) falhou)
+*/
+static FatorIC_t *fatoraIC (SistLinear_t *SL)
+{
+    unsigned int n = SL->n, i, j, k, nnz = 0;
+
+    MarcaArena_t marca = arenaMarca();
+    FatorIC_t *L = arenaAloca(sizeof(FatorIC_t));
+    L->lin = arenaAloca(sizeof(unsigned int) * (n + 1));
+
+    for (i = 0; i < n; i++){
+        L->lin[i] = nnz;
+        for (j = 0; j < i; j++)
+            if (SL->A[i][j] != 0.0f)
+                nnz++;
+        nnz++; // diagonal
+    }
+    L->lin[n] = nnz;
+
+    L->val = arenaAloca(sizeof(real_t) * nnz);
+    L->col = arenaAloca(sizeof(unsigned int) * nnz);
+
+    for (i = 0; i < n; i++){
+        unsigned int p = L->lin[i];
+        for (j = 0; j < i; j++)
+            if (SL->A[i][j] != 0.0f){
+                L->col[p] = j;
+                L->val[p++] = SL->A[i][j];
+            }
+        L->col[p] = i;
+        L->val[p] = SL->A[i][i];
+    }
+
+    for (i = 0; i < n; i++){
+        unsigned int diag = L->lin[i + 1] - 1;
+        double quad = 0.0;
+
+        for (unsigned int p = L->lin[i]; p < diag; p++){
+            k = L->col[p];
+            // Produto das partes já calculadas das linhas i e k (colunas < k)
+            double sum = 0.0;
+            unsigned int a = L->lin[i], b = L->lin[k], fimK = L->lin[k + 1] - 1;
+            while (a < p && b < fimK){
+                if (L->col[a] < L->col[b]) a++;
+                else if (L->col[a] > L->col[b]) b++;
+                else sum += (double) L->val[a++] * L->val[b++];
+            }
+            L->val[p] = (L->val[p] - sum) / L->val[fimK];
+            quad += (double) L->val[p] * L->val[p];
+        }
+
+        double d = L->val[diag] - quad;
+        if (!(d > 0.0)){
+            arenaRetorna(marca);
+            return NULL;
+        }
+        L->val[diag] = sqrt(d);
+    }
+
+    return L;
+}
+
+
+// z = (LL^T)^-1 r
+static void aplicaIC (FatorIC_t *L, unsigned int n, const real_t *r, real_t *z)
+{
+    unsigned int i, p;
+
+    // Ly = r
+    for (i = 0; i < n; i++){
+        double sum = r[i];
+        for (p = L->lin[i]; p < L->lin[i + 1] - 1; p++)
+            sum -= (double) L->val[p] * z[L->col[p]];
+        z[i] = sum / L->val[p];
+    }
+
+    // L^T z = y, por linhas de L: cada z[i] pronto é retirado das linhas anteriores
+    for (i = n; i-- > 0; ){
+        p = L->lin[i + 1] - 1;
+        z[i] /= L->val[p];
+        for (p = L->lin[i]; p < L->lin[i + 1] - 1; p++)
+            z[L->col[p]] -= L->val[p] * z[i];
+    }
+}
+
+
+/*!
+  \brief Método do Gradiente Conjugado com precondicionador de Jacobi
+
+  \param SL Ponteiro para o sistema linear (simétrico e positivo definido)
+  \param x ponteiro para o vetor solução. Ao iniciar função contém
+            valor inicial
+  \param tTotal time gasto pelo método
+
+  \return código de erro. Um nr positivo indica sucesso e o nr
+          de iterações realizadas. Um nr. negativo indica um erro:
+          -1 (não simétrico) -2 (não positivo definido)
+  */
+int gradienteConjugado (SistLinear_t *SL, real_t *x, double *tTotal)
+{
+    return gradienteConjugadoPrecond(SL, x, PRECOND_JACOBI, tTotal);
+}
+
+
+/*!
+  \brief Método do Gradiente Conjugado precondicionado
+
+  Para quando o passo alfa*p, como a diferença entre iterações dos demais
+  métodos, fica abaixo de SL->erro.
+
+  \param SL Ponteiro para o sistema linear (simétrico e positivo definido)
+  \param x ponteiro para o vetor solução. Ao iniciar função contém
+            valor inicial
+  \param M precondicionador
+  \param tTotal time gasto pelo método
+
+  \return código de erro. Um nr positivo indica sucesso e o nr
+          de iterações realizadas. Um nr. negativo indica um erro:
+          -1 (não simétrico) -2 (não positivo definido)
+  */
+int gradienteConjugadoPrecond (SistLinear_t *SL, real_t *x, Precond_t M, double *tTotal)
+{
+    unsigned int n = SL->n;
+    int i;
+
+    if (!simetrica(SL)){
+        fprintf(stderr, "Conjugate Gradient: matrix is not symmetric.\n");
+        return -1;
+    }
+
+    double time = timestamp();
+    MarcaArena_t marca = arenaMarca();
+
+    FatorIC_t *L = NULL;
+    real_t *diag = NULL;
+    if (M == PRECOND_CHOLESKY && !(L = fatoraIC(SL))){
+        fprintf(stderr, "Conjugate Gradient: IC(0) breakdown, using Jacobi.\n");
+        M = PRECOND_JACOBI;
+    }
+    if (M == PRECOND_JACOBI){
+        diag = arenaAloca(sizeof(real_t) * n);
+        for (i = 0; i < n; i++){
+            if (SL->A[i][i] <= 0.0f){
+                fprintf(stderr, "Conjugate Gradient: matrix is not positive definite.\n");
+                arenaRetorna(marca);
+                return -2;
+            }
+            diag[i] = 1.0f / SL->A[i][i];
+        }
+    }
+
+    real_t *curr = arenaAloca(sizeof(real_t) * n);
+    real_t *r = arenaAloca(sizeof(real_t) * n);
+    real_t *z = arenaAloca(sizeof(real_t) * n);
+    real_t *p = arenaAloca(sizeof(real_t) * n);
+    real_t *Ap = arenaAloca(sizeof(real_t) * n);
+
+    real_t diff = FLT_MAX;
+    int erro = 0, paralelo = numThreads() > 1 && n >= ITER_PARALELO;
+
+    // Parte de x: r = b - Ax
+    memcpy(curr, x, sizeof(real_t) * n);
+    #pragma omp parallel for if(paralelo)
+    for (i = 0; i < n; i++)
+        r[i] = SL->b[i] - produtoInterno(SL->A[i], curr, n);
+    int iter = 0;
+    double rz = 0.0;
+
+    while (iter < MAXIT_GC && diff > SL->erro){
+        // z = M^-1 r
+        INSTR_INICIO(FASE_PRECOND);
+        if (M == PRECOND_JACOBI)
+            for (i = 0; i < n; i++)
+                z[i] = diag[i] * r[i];
+        else if (M == PRECOND_CHOLESKY)
+            aplicaIC(L, n, r, z);
+        else
+            memcpy(z, r, sizeof(real_t) * n);
+        INSTR_FIM(FASE_PRECOND);
+
+        INSTR_INICIO(FASE_VETORES);
+        double rz_novo = produtoInterno(r, z, n);
+        if (rz_novo == 0.0){ // resíduo nulo: solução exata
+            INSTR_FIM(FASE_VETORES);
+            break;
+        }
+
+        if (iter == 0)
+            memcpy(p, z, sizeof(real_t) * n);
+        else {
+            real_t beta = rz_novo / rz;
+            for (i = 0; i < n; i++)
+                p[i] = z[i] + beta * p[i];
+        }
+        rz = rz_novo;
+        INSTR_FIM(FASE_VETORES);
+
+        INSTR_INICIO(FASE_VARREDURA);
+        #pragma omp parallel for if(paralelo)
+        for (i = 0; i < n; i++)
+            Ap[i] = produtoInterno(SL->A[i], p, n);
+        INSTR_FIM(FASE_VARREDURA);
+
+        INSTR_INICIO(FASE_VETORES);
+        double pAp = produtoInterno(p, Ap, n);
+        if (!(pAp > 0.0)){
+            INSTR_FIM(FASE_VETORES);
+            erro = invalid(pAp) ? -3 : -2;
+            break;
+        }
+
+        real_t alfa = rz / pAp;
+        diff = 0.0f;
+        for (i = 0; i < n; i++){
+            curr[i] += alfa * p[i];
+            r[i] -= alfa * Ap[i];
+            real_t d = fabs(alfa * p[i]);
+            if (d > diff)
+                diff = d;
+        }
+        iter++;
+        INSTR_FIM(FASE_VETORES);
+
+        INSTR_INICIO(FASE_CONVERGENCIA);
+        int invalido = vetor_invalido(curr, n);
+        INSTR_FIM(FASE_CONVERGENCIA);
+        if (invalido){
+            erro = -3;
+            break;
+        }
+    }
+
+    *tTotal = timestamp() - time;
+    if (erro)
+        fprintf(stderr, erro == -2 ? "Conjugate Gradient: matrix is not positive definite.\n"
+                                   : "Conjugate Gradient floating point error.\n");
+    else
+        memcpy(x, curr, sizeof(real_t) * n);
+
+    arenaRetorna(marca);
+
+    return erro ? erro : iter;
+}
+
+
+/*!
+  \brief Refinamento de precisão mista
+
+  A matriz é fatorada uma única vez em real_t; resíduos e correções são
+  acumulados em double. Para quando a correção fica abaixo da precisão
+  double da solução ou deixa de diminuir (estagnação).
+
+  \param SL Ponteiro para o sistema linear
+  \param x ponteiro para o vetor solução em double. Ao iniciar função
+            contém valor inicial para início do refinamento
+  \param tTotal time gasto pelo método
+
+  \return código de erro. Um nr positivo indica sucesso e o nr
+          de iterações realizadas. Um nr. negativo indica um erro:
+          -1 (não converge) -2 (sem solução)
+  */
+int refinamentoMisto(SistLinear_t *SL, double *x, double *tTotal)
+{
+    int iter = 0, result;
+    double dx, x_norma, prev_dx = DBL_MAX, time = timestamp();
+
+    // Em geral a fatoração da eliminação de Gauss do mesmo sistema, que não
+    // é reaproveitamento entre sistemas: não conta nas estatísticas do cache
+    EntradaLU_t *E = obtemFatorLU(SL, 0);
+    result = E ? 0 : -1;
+    while (result >= 0 && iter < MAXIT){
+        result = refine(SL, E->LU, x, &dx);
+        if (result < 0)
+            break;
+        iter++;
+
+        x_norma = 0.0;
+        for (int i = 0; i < SL->n; i++)
+            if (fabs(x[i]) > x_norma)
+                x_norma = fabs(x[i]);
+
+        // Correção abaixo da precisão de x ou sem ganho em relação ao passo anterior
+        if (dx <= x_norma * DBL_EPSILON || dx > prev_dx / 2.0)
+            break;
+        prev_dx = dx;
+    }
+
+    *tTotal = timestamp() - time;
+
+    if (E)
+        devolveFatorLU(E);
+
+    return result < 0 ? result : iter;
+}
+
+
 /*!
   \brief Método de Refinamento
 
@@ -271,32 +1025,59 @@ int gaussSeidel (SistLinear_t *SL, real_t *x, double *tTotal)
   */
 int refinamento(SistLinear_t *SL, real_t *x, double *tTotal)
 {
-    real_t *prev_iter = malloc(sizeof(real_t) * SL->n);
-    must_alloc(prev_iter, __func__);
+    MarcaArena_t marca = arenaMarca();
+    double *xd = arenaAloca(sizeof(double) * SL->n);
 
-    real_t norma = normaL2Residuo(SL, x, residue(SL, x));
+    for (int i = 0; i < SL->n; i++)
+        xd[i] = x[i];
 
-    int iter, result;
-    double time = timestamp();
-    for (iter = 0; iter < MAXIT && norma > MAXNORMA; iter++){
-        result = refine(SL, x);
-        if (result < 0)
-            return result;
+    int result = refinamentoMisto(SL, xd, tTotal);
 
-        norma = normaL2Residuo(SL, x, residue(SL, x));
-        
-        // Critério de parada b
-        if (max_distance(prev_iter, x, SL->n) < SL->erro){
-            *tTotal = timestamp() - time;
-            return iter;
-        } 
-        memcpy(prev_iter, x, sizeof(real_t) * SL->n);
-        
-    }
+    if (result >= 0)
+        for (int i = 0; i < SL->n; i++)
+            x[i] = (real_t) xd[i];
 
-    *tTotal = timestamp() - time;
+    arenaRetorna(marca);
 
-    return iter;
+    return result;
+}
+
+
+/*!
+  \brief Alocaçao de memória de uma fatoração LU
+
+  \param n tamanho do SL
+
+  \return ponteiro para a fatoração
+  */
+FatorLU_t *alocaFatorLU(unsigned int n)
+{
+    FatorLU_t *new = (FatorLU_t*) malloc(sizeof(FatorLU_t));
+    must_alloc(new, __func__);
+
+    new->n = n;
+
+    // Matriz contígua, linhas alinhadas
+    new->lda = calculaLda(n);
+    new->LU = alocaMatriz(n, new->lda);
+
+    new->p = (unsigned int*) malloc(n * sizeof(unsigned int));
+    must_alloc(new->p, __func__);
+
+    return new;
+}
+
+
+/*!
+  \brief Liberaçao de memória de uma fatoração LU
+
+  \param LU fatoração
+  */
+void liberaFatorLU (FatorLU_t *LU)
+{
+    liberaMatriz(LU->LU);
+    free(LU->p);
+    free(LU);
 }
 
 
@@ -308,24 +1089,37 @@ int refinamento(SistLinear_t *SL, real_t *x, double *tTotal)
   \return ponteiro para SL. NULL se houve erro de alocação
   */
 SistLinear_t *alocaSistLinear(unsigned int n)
+{
+    return alocaSistLinearMultiplo(n, 1);
+}
+
+
+/*!
+  \brief Alocaçao de memória para um SL com várias colunas de termos independentes
+
+  \param n tamanho do SL
+  \param nrhs número de colunas de b
+
+  \return ponteiro para SL. NULL se houve erro de alocação
+  */
+SistLinear_t *alocaSistLinearMultiplo(unsigned int n, unsigned int nrhs)
 {
     SistLinear_t *new = (SistLinear_t*) malloc(sizeof(SistLinear_t));
     must_alloc(new, __func__);
 
     new->n = n;
 
-    // Alocação de matriz contígua
-    new->A = (real_t**) malloc(n * sizeof(real_t*));
-    must_alloc(new->A, __func__);
-
-    new->A[0] = (real_t*) calloc(n * n, sizeof(real_t));
-    must_alloc(new->A[0], __func__);
+    // Matriz contígua, linhas alinhadas
+    new->lda = calculaLda(n);
+    new->A = alocaMatriz(n, new->lda);
 
-    for (int i = 0; i < n; i++)
-        new->A[i] = new->A[0] + i * n;
-
-    new->b = (real_t*) calloc(n, sizeof(real_t));
+    new->b = (real_t*) calloc((size_t) n * nrhs, sizeof(real_t));
     must_alloc(new->b, __func__);
+    new->nrhs = nrhs;
+
+    // Sem detectaBanda, a matriz é tratada como cheia
+    new->kl = new->ku = n ? n - 1 : 0;
+    new->perm = NULL;
 
     new->erro = (real_t) 0.0f;
 
@@ -340,9 +1134,9 @@ SistLinear_t *alocaSistLinear(unsigned int n)
   */
 void liberaSistLinear (SistLinear_t *SL)
 {
-    free(SL->A[0]);
-    free(SL->A);
+    liberaMatriz(SL->A);
     free(SL->b);
+    free(SL->perm);
     free(SL);
 }
 
@@ -350,24 +1144,41 @@ void liberaSistLinear (SistLinear_t *SL)
 /*!
   \brief Leitura de SL a partir de Entrada padrão (stdin).
 
+  A primeira linha tem n e, opcionalmente, o número k de colunas de b.
+  Seguem erro, A (n x n) e b (n x k, linha a linha; com k = 1 os n valores
+  podem estar numa única linha).
+
   \return sistema linear SL. NULL se houve erro (leitura ou alocação)
   */
 SistLinear_t *lerSistLinear ()
 {
-    unsigned int n;
+    unsigned int n, k;
     real_t erro;
-    fscanf(stdin, "%u\n%e\n", &n, &erro);
-
-    SistLinear_t* SL = alocaSistLinear(n);
+    if (!leInteiro(&n))
+        return NULL;
+    if (!leInteiroNaLinha(&k))
+        k = 1;
+    if (k == 0 || !leReal(&erro))
+        return NULL;
+
+    SistLinear_t* SL = alocaSistLinearMultiplo(n, k);
     SL->erro = erro;
 
     for (int i = 0; i < n; i++)
         for (int j = 0; j < n; j++)
-            fscanf(stdin, "%f", &(SL->A[i][j]));
+            if (!leReal(&(SL->A[i][j]))){
+                liberaSistLinear(SL);
+                return NULL;
+            }
 
     for (int i = 0; i < n; i++)
-        fscanf(stdin, "%f", &(SL->b[i]));
+        for (int c = 0; c < k; c++)
+            if (!leReal(&(SL->b[(size_t) c * n + i]))){
+                liberaSistLinear(SL);
+                return NULL;
+            }
 
+    detectaBanda(SL);
     return SL;
 }
 
@@ -382,8 +1193,32 @@ void prnSistLinear (SistLinear_t *SL)
 
 // Exibe um vetor na saída padrão
 void prnVetor (real_t *v, unsigned int n)
+{
+    fprnVetor(stdout, v, n);
+}
+
+
+// Escreve um vetor no arquivo 'f'
+void fprnVetor (FILE *f, real_t *v, unsigned int n)
 {
     for (int i = 0; i < n; i++)
-        printf("%f ", v[i]);
-    printf("\n");
+        fprintf(f, "%f ", v[i]);
+    fprintf(f, "\n");
+}
+
+
+// Escreve a solução x de SL no arquivo 'f', desfazendo a reordenação de SL
+void fprnSolucao (FILE *f, SistLinear_t *SL, real_t *x)
+{
+    if (!SL->perm){
+        fprnVetor(f, x, SL->n);
+        return;
+    }
+
+    MarcaArena_t marca = arenaMarca();
+    real_t *orig = arenaAloca(sizeof(real_t) * SL->n);
+    for (int i = 0; i < SL->n; i++)
+        orig[SL->perm[i]] = x[i];
+    fprnVetor(f, orig, SL->n);
+    arenaRetorna(marca);
 }
@@ -1,39 +1,112 @@
 #ifndef __SISLINEAR_H__
 #define __SISLINEAR_H__
 
+#include <stdio.h>
+
 // Parâmetros para teste de convergência
 #define MAXIT   50  // Número máximo de iterações em métodos iterativos
+#define ITER_PARALELO 128  // Menor n com varreduras paralelas nos métodos iterativos
+#define MAXIT_GC 1000  // Número máximo de iterações do gradiente conjugado
+
+// Parâmetros da fatoração LU blocada
+#define LU_BLOCO 64   // Largura (em colunas) de cada painel
+#define LU_FAIXA 256  // Largura das faixas de colunas na atualização do restante da matriz
+#define LU_PARALELO 256  // Menor n fatorado com tarefas paralelas
+#define RHS_BLOCO 32  // Colunas de termos independentes resolvidas juntas por luSolveMultiplo
+
+// Disposição das matrizes: linhas alinhadas a 64 bytes, com a distância entre
+// linhas (lda) múltipla de SL_LDA_MULTIPLO elementos e nunca múltipla de
+// 4 KiB, o que evitaria que linhas vizinhas disputassem o mesmo conjunto da cache
+#define SL_ALINHAMENTO 64
+#define SL_LDA_MULTIPLO (SL_ALINHAMENTO / sizeof(real_t))
+#define SL_PAGINA_GRANDE ((size_t) 4 << 20)  // Matrizes a partir deste tamanho pedem huge pages (0 desativa)
 
 typedef float real_t;
 
 typedef struct {
   unsigned int n; // tamanho do SL
   real_t erro; // critério de parada
-  real_t **A; // coeficientes
-  real_t *b; // termos independentes
+  real_t **A; // coeficientes: A[i] = A[0] + i*lda
+  unsigned int lda; // distância entre linhas de A, em elementos (>= n)
+  real_t *b; // termos independentes: nrhs colunas de n elementos, uma após a outra
+  unsigned int nrhs; // número de colunas de b
+  unsigned int kl, ku; // larguras de banda abaixo/acima da diagonal (ver detectaBanda)
+  unsigned int *perm; // se reordenado: variável i é a perm[i] do original (NULL se não)
 } SistLinear_t;
 
+// Precondicionadores do gradiente conjugado
+typedef enum {
+  PRECOND_NENHUM,
+  PRECOND_JACOBI, // diagonal de A
+  PRECOND_CHOLESKY // Cholesky incompleto IC(0), no padrão de não nulos de A
+} Precond_t;
+
+typedef struct {
+  unsigned int n; // tamanho do SL fatorado
+  real_t **LU; // L abaixo da diagonal (diagonal unitária implícita) e U no restante
+  unsigned int lda; // distância entre linhas de LU, em elementos
+  unsigned int *p; // permutação: linha i de LU corresponde à linha p[i] de A
+} FatorLU_t;
+
 // Alocaçao e desalocação de memória
 SistLinear_t* alocaSistLinear (unsigned int n);
+SistLinear_t* alocaSistLinearMultiplo (unsigned int n, unsigned int nrhs);
 void liberaSistLinear (SistLinear_t *SL);
 
+// Alocaçao e desalocação de memória de uma fatoração LU
+FatorLU_t *alocaFatorLU (unsigned int n);
+void liberaFatorLU (FatorLU_t *LU);
+
 // Leitura e impressão de sistemas lineares
 SistLinear_t *lerSistLinear ();
 void prnSistLinear (SistLinear_t *SL);
 void prnVetor (real_t *vet, unsigned int n);
+void fprnVetor (FILE *f, real_t *vet, unsigned int n);
+
+// Escreve a solução x de SL, na ordem original das variáveis se SL foi reordenado
+void fprnSolucao (FILE *f, SistLinear_t *SL, real_t *x);
 
 // Retorna a normaL2 do resíduo. Parâmetro 'res' deve ter o resíduo.
 real_t normaL2Residuo(SistLinear_t *SL, real_t *x, real_t *res);
 
+// Fatoração LU com pivoteamento parcial. Resultado no parâmetro 'LU'
+int fatoraLU (SistLinear_t *SL, FatorLU_t *LU);
+
+// Resolve LUx = Pb usando uma fatoração já calculada. 'b' e 'x' devem ser distintos
+int luSolve (FatorLU_t *LU, real_t *b, real_t *x);
+
+// Resolve LUX = PB para as k colunas de B (n x k, coluna a coluna). Resultado em 'X',
+// no mesmo formato. 'B' e 'X' podem coincidir
+int luSolveMultiplo (FatorLU_t *LU, real_t *B, real_t *X, unsigned int k);
+
 // Método da Eliminação de Gauss. Resultado no parâmetro 'x'
 int eliminacaoGauss (SistLinear_t *SL, real_t *x, double *tTotal);
 
+// Eliminação de Gauss para todas as colunas de b com uma única fatoração.
+// Resultado no parâmetro 'X' (n x nrhs, coluna a coluna)
+int eliminacaoGaussMultiplo (SistLinear_t *SL, real_t *X, double *tTotal);
+
 // Método de Jacobi. Valor inicial e resultado no parâmetro 'x' 
 int gaussJacobi (SistLinear_t *SL, real_t *x, double *tTotal);
 
 // Método de Gauss-Seidel. Valor inicial e resultado no parâmetro 'x' 
 int gaussSeidel (SistLinear_t *SL, real_t *x, double *tTotal);
 
+// Método de Gauss-Seidel multicolorido (paralelo) com relaxação 'omega' (SOR).
+// Convergência garantida só para omega <= 1. Valor inicial e resultado no parâmetro 'x'
+int gaussSeidelMulticor (SistLinear_t *SL, real_t *x, real_t omega, double *tTotal);
+
+// Gradiente Conjugado para A simétrica positiva definida, precondicionado por
+// Jacobi. Valor inicial e resultado no parâmetro 'x'
+int gradienteConjugado (SistLinear_t *SL, real_t *x, double *tTotal);
+
+// Gradiente Conjugado com o precondicionador 'M'
+int gradienteConjugadoPrecond (SistLinear_t *SL, real_t *x, Precond_t M, double *tTotal);
+
+// Refinamento de precisão mista (fatoração em real_t, resíduos em double).
+// Valor inicial e resultado no parâmetro 'x'
+int refinamentoMisto (SistLinear_t *SL, double *x, double *tTotal);
+
 // Método de Refinamento. Valor inicial e resultado no parâmetro 'x'
 int refinamento (SistLinear_t *SL, real_t *x, double *tTotal);
 
@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "SistemasLote.h"
+#include "instrumenta.h"
+
+#define W LOTE_LARGURA
+
+
+/*!
+  \brief Alocaçao de memória
+
+  \param n tamanho de cada SL
+  \param nsis número de sistemas
+
+  \return ponteiro para o lote
+  */
+LoteSL_t *alocaLote (unsigned int n, unsigned int nsis)
+{
+    LoteSL_t *new = (LoteSL_t*) malloc(sizeof(LoteSL_t));
+    must_alloc(new, __func__);
+
+    new->n = n;
+    new->nsis = nsis;
+    new->nblocos = (nsis + W - 1) / W;
+
+    new->A = (real_t*) calloc((size_t) new->nblocos * n * n * W, sizeof(real_t));
+    must_alloc(new->A, __func__);
+
+    new->b = (real_t*) calloc((size_t) new->nblocos * n * W, sizeof(real_t));
+    must_alloc(new->b, __func__);
+
+    // Vagas sem sistema recebem a identidade, evitando pivôs nulos
+    for (unsigned int s = nsis; s < new->nblocos * W; s++)
+        for (unsigned int i = 0; i < n; i++)
+            new->A[(((size_t) (s / W) * n + i) * n + i) * W + s % W] = 1.0f;
+
+    return new;
+}
+
+
+/*!
+  \brief Liberaçao de memória
+
+  \param L lote
+  */
+void liberaLote (LoteSL_t *L)
+{
+    free(L->A);
+    free(L->b);
+    free(L);
+}
+
+
+// Copia o sistema SL para a posição 's' do lote
+void loteInsere (LoteSL_t *L, unsigned int s, SistLinear_t *SL)
+{
+    unsigned int n = L->n;
+    real_t *A = L->A + (size_t) (s / W) * n * n * W + s % W;
+    real_t *b = L->b + (size_t) (s / W) * n * W + s % W;
+
+    for (unsigned int i = 0; i < n; i++){
+        for (unsigned int j = 0; j < n; j++)
+            A[(i * n + j) * W] = SL->A[i][j];
+        b[i * W] = SL->b[i];
+    }
+}
+
+
+// Copia a solução do sistema 's' do lote para 'x'
+void loteSolucao (LoteSL_t *L, unsigned int s, real_t *X, real_t *x)
+{
+    real_t *Xs = X + (size_t) (s / W) * L->n * W + s % W;
+    for (unsigned int i = 0; i < L->n; i++)
+        x[i] = Xs[i * W];
+}
+
+
+// Resolve os W sistemas de um bloco. Todos os laços internos percorrem os
+// sistemas do bloco ('s'), que são contíguos na memória
+static void resolveBloco (real_t *A, real_t *b, real_t *x, unsigned int n, int *falha)
+{
+    real_t m[W], max[W];
+    unsigned int p[W];
+    unsigned int i, j, k, s;
+
+    for (s = 0; s < W; s++)
+        falha[s] = 0;
+
+    for (k = 0; k < n; k++){
+        real_t *Ak = A + k * n * W;
+
+        // Pivoteamento parcial, independente para cada sistema
+        INSTR_INICIO(FASE_PIVO);
+        for (s = 0; s < W; s++){
+            max[s] = fabsf(Ak[k * W + s]);
+            p[s] = k;
+        }
+        for (i = k + 1; i < n; i++){
+            real_t *Aik = A + (i * n + k) * W;
+            for (s = 0; s < W; s++)
+                if (fabsf(Aik[s]) > max[s]){
+                    max[s] = fabsf(Aik[s]);
+                    p[s] = i;
+                }
+        }
+        INSTR_FIM(FASE_PIVO);
+
+        INSTR_INICIO(FASE_TROCA);
+        for (s = 0; s < W; s++){
+            if (max[s] == 0.0f)
+                falha[s] = 1;
+
+            if (p[s] != k){
+                real_t aux, *Ap = A + p[s] * n * W;
+                for (j = k; j < n; j++){
+                    aux = Ak[j * W + s];
+                    Ak[j * W + s] = Ap[j * W + s];
+                    Ap[j * W + s] = aux;
+                }
+                aux = b[k * W + s];
+                b[k * W + s] = b[p[s] * W + s];
+                b[p[s] * W + s] = aux;
+            }
+        }
+        INSTR_FIM(FASE_TROCA);
+
+        INSTR_INICIO(FASE_ELIMINACAO);
+        for (i = k + 1; i < n; i++){
+            real_t *Ai = A + i * n * W;
+            for (s = 0; s < W; s++)
+                m[s] = Ai[k * W + s] / Ak[k * W + s];
+
+            for (j = k + 1; j < n; j++)
+                for (s = 0; s < W; s++)
+                    Ai[j * W + s] -= m[s] * Ak[j * W + s];
+
+            for (s = 0; s < W; s++)
+                b[i * W + s] -= m[s] * b[k * W + s];
+        }
+        INSTR_FIM(FASE_ELIMINACAO);
+    }
+
+    // Retrossubstituição
+    INSTR_INICIO(FASE_SUBSTITUICAO);
+    for (i = n; i-- > 0; ){
+        real_t *Ai = A + i * n * W;
+        for (s = 0; s < W; s++)
+            m[s] = b[i * W + s];
+        for (j = i + 1; j < n; j++)
+            for (s = 0; s < W; s++)
+                m[s] -= Ai[j * W + s] * x[j * W + s];
+        for (s = 0; s < W; s++)
+            x[i * W + s] = m[s] / Ai[i * W + s];
+    }
+    INSTR_FIM(FASE_SUBSTITUICAO);
+
+    INSTR_INICIO(FASE_CONVERGENCIA);
+    for (s = 0; s < W; s++)
+        for (i = 0; i < n; i++)
+            if (invalid(x[i * W + s]))
+                falha[s] = 1;
+    INSTR_FIM(FASE_CONVERGENCIA);
+}
+
+
+/*!
+  \brief Eliminação de Gauss em um lote de sistemas
+
+  Vetoriza entre os sistemas de cada bloco e distribui os blocos entre as
+  threads.
+
+  \param L Ponteiro para o lote. A e b são sobrescritos
+  \param X vetor de soluções, no mesmo leiaute de 'b'
+  \param status se não nulo, recebe 0 (sucesso) ou -1 (erro) para cada sistema
+  \param tTotal time gasto pelo método
+
+  \return número de sistemas que falharam
+*/
+int resolveLote (LoteSL_t *L, real_t *X, int *status, double *tTotal)
+{
+    unsigned int n = L->n;
+    int falhas = 0, paralelo = numThreads() > 1 && L->nblocos > 1;
+    double time = timestamp();
+
+    #pragma omp parallel for schedule(dynamic) reduction(+: falhas) if(paralelo)
+    for (unsigned int k = 0; k < L->nblocos; k++){
+        int falha[W];
+        resolveBloco(L->A + (size_t) k * n * n * W, L->b + (size_t) k * n * W,
+                     X + (size_t) k * n * W, n, falha);
+
+        for (unsigned int s = 0; s < W && k * W + s < L->nsis; s++){
+            if (status)
+                status[k * W + s] = falha[s] ? -1 : 0;
+            falhas += falha[s];
+        }
+    }
+
+    *tTotal = timestamp() - time;
+
+    return falhas;
+}
@@ -0,0 +1,34 @@
+#ifndef __SISLOTE_H__
+#define __SISLOTE_H__
+
+#include "SistemasLineares.h"
+
+#define LOTE_LARGURA 16  // Sistemas intercalados em cada bloco do lote (múltiplo da largura SIMD)
+
+// Lote de sistemas de mesmo tamanho. Os sistemas são agrupados em blocos de
+// LOTE_LARGURA e, dentro de cada bloco, um mesmo coeficiente de todos os
+// sistemas fica contíguo (SoA), para que cada operação seja vetorizada
+// entre sistemas. Vagas não usadas do último bloco têm A = I e b = 0
+typedef struct {
+  unsigned int n; // tamanho de cada SL
+  unsigned int nsis; // número de sistemas no lote
+  unsigned int nblocos; // número de blocos de LOTE_LARGURA sistemas
+  real_t *A; // coeficiente (i,j) do sistema s: A[((bloco * n + i) * n + j) * LOTE_LARGURA + s % LOTE_LARGURA]
+  real_t *b; // termo i do sistema s: b[(bloco * n + i) * LOTE_LARGURA + s % LOTE_LARGURA]
+} LoteSL_t;
+
+// Alocaçao e desalocação de memória
+LoteSL_t *alocaLote (unsigned int n, unsigned int nsis);
+void liberaLote (LoteSL_t *L);
+
+// Copia o sistema SL para a posição 's' do lote
+void loteInsere (LoteSL_t *L, unsigned int s, SistLinear_t *SL);
+
+// Copia para 'x' a solução do sistema 's', a partir do vetor de soluções 'X' do lote
+void loteSolucao (LoteSL_t *L, unsigned int s, real_t *X, real_t *x);
+
+// Eliminação de Gauss com pivoteamento parcial em todos os sistemas do lote.
+// Sobrescreve A e b. 'X' deve ter nblocos * n * LOTE_LARGURA elementos
+int resolveLote (LoteSL_t *L, real_t *X, int *status, double *tTotal);
+
+#endif // __SISLOTE_H__
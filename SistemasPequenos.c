@@ -0,0 +1,232 @@
+#include <stdio.h>
+#include <math.h>
+#include <string.h>
+#include <float.h>
+
+#include "utils.h"
+#include "SistemasPequenos.h"
+#include "instrumenta.h"
+
+/*  Cada método é escrito uma única vez, com o tamanho N como parâmetro, e
+    sempre expandido (always_inline) nas instâncias geradas por INSTANCIA(N).
+    Com N constante o compilador desenrola todos os laços e elimina os testes
+    de índice, e as matrizes locais de tamanho fixo ficam em registradores ou
+    na pilha, sem indireção por real_t** nem alocação.
+*/
+#define ESPECIALIZADO static inline __attribute__((always_inline))
+
+
+ESPECIALIZADO int gaussN (const unsigned int N, SistLinear_t *SL, real_t *x)
+{
+    real_t a[PEQUENO_MAX][PEQUENO_MAX], b[PEQUENO_MAX], aux, m;
+    unsigned int i, j, k, p;
+
+    for (i = 0; i < N; i++){
+        for (j = 0; j < N; j++)
+            a[i][j] = SL->A[i][j];
+        b[i] = SL->b[i];
+    }
+
+    for (k = 0; k < N; k++){
+        // Pivoteamento parcial
+        INSTR_INICIO(FASE_PIVO);
+        p = k;
+        for (i = k + 1; i < N; i++)
+            if (fabsf(a[i][k]) > fabsf(a[p][k]))
+                p = i;
+        INSTR_FIM(FASE_PIVO);
+
+        if (a[p][k] == 0.0f){
+            fprintf(stderr, "Gauss-Jordan floating point error.\n");
+            return -1;
+        }
+
+        INSTR_INICIO(FASE_TROCA);
+        for (j = k; j < N; j++){
+            aux = a[k][j];
+            a[k][j] = a[p][j];
+            a[p][j] = aux;
+        }
+        aux = b[k];
+        b[k] = b[p];
+        b[p] = aux;
+        INSTR_FIM(FASE_TROCA);
+
+        INSTR_INICIO(FASE_ELIMINACAO);
+        for (i = k + 1; i < N; i++){
+            m = a[i][k] / a[k][k];
+            for (j = k + 1; j < N; j++)
+                a[i][j] -= m * a[k][j];
+            b[i] -= m * b[k];
+        }
+        INSTR_FIM(FASE_ELIMINACAO);
+    }
+
+    INSTR_INICIO(FASE_SUBSTITUICAO);
+    for (i = N; i-- > 0; ){
+        double sum = b[i];
+        for (j = i + 1; j < N; j++)
+            sum -= a[i][j] * x[j];
+        x[i] = sum / a[i][i];
+    }
+    INSTR_FIM(FASE_SUBSTITUICAO);
+
+    if (vetor_invalido(x, N)){
+        fprintf(stderr, "Retrosubs floating point failure.\n");
+        return -1;
+    }
+    return 0;
+}
+
+
+ESPECIALIZADO int jacobiN (const unsigned int N, SistLinear_t *SL, real_t *x)
+{
+    real_t a[PEQUENO_MAX][PEQUENO_MAX], b[PEQUENO_MAX];
+    real_t curr[PEQUENO_MAX], next[PEQUENO_MAX];
+    real_t diff = FLT_MAX;
+    unsigned int i, k;
+    int iter;
+
+    for (i = 0; i < N; i++){
+        for (k = 0; k < N; k++)
+            a[i][k] = SL->A[i][k];
+        b[i] = SL->b[i];
+        curr[i] = x[i];
+    }
+
+    for (iter = 0; iter < MAXIT && diff > SL->erro; iter++){
+        diff = 0.0f;
+        INSTR_INICIO(FASE_VARREDURA);
+        for (i = 0; i < N; i++){
+            double sum = 0.0f;
+            for (k = 0; k < N; k++)
+                if (k != i)
+                    sum += a[i][k] * curr[k];
+
+            if (a[i][i] == 0.0f && (b[i] - sum) != 0.0f){
+                INSTR_FIM(FASE_VARREDURA);
+                fprintf(stderr, "Gauss-Jacobi no solution.\n");
+                return -2;
+            }
+            next[i] = (b[i] - sum) / a[i][i];
+            if (fabsf(next[i] - curr[i]) > diff)
+                diff = fabsf(next[i] - curr[i]);
+        }
+        INSTR_FIM(FASE_VARREDURA);
+
+        INSTR_INICIO(FASE_CONVERGENCIA);
+        int invalido = vetor_invalido(next, N);
+        INSTR_FIM(FASE_CONVERGENCIA);
+        if (invalido){
+            fprintf(stderr, "Gauss-Jacobi floating point error.\n");
+            return -3;
+        }
+
+        INSTR_INICIO(FASE_COPIA);
+        for (i = 0; i < N; i++)
+            curr[i] = next[i];
+        INSTR_FIM(FASE_COPIA);
+    }
+
+    memcpy(x, curr, sizeof(real_t) * N);
+    return iter;
+}
+
+
+ESPECIALIZADO int seidelN (const unsigned int N, SistLinear_t *SL, real_t *x)
+{
+    real_t a[PEQUENO_MAX][PEQUENO_MAX], b[PEQUENO_MAX];
+    real_t curr[PEQUENO_MAX], novo;
+    real_t diff = FLT_MAX;
+    unsigned int i, k;
+    int iter;
+
+    for (i = 0; i < N; i++){
+        for (k = 0; k < N; k++)
+            a[i][k] = SL->A[i][k];
+        b[i] = SL->b[i];
+        curr[i] = x[i];
+    }
+
+    for (iter = 0; iter < MAXIT && diff > SL->erro; iter++){
+        diff = 0.0f;
+        INSTR_INICIO(FASE_VARREDURA);
+        for (i = 0; i < N; i++){
+            double sum = 0.0f;
+            for (k = 0; k < N; k++)
+                if (k != i)
+                    sum += a[i][k] * curr[k];
+
+            if (a[i][i] == 0.0f && b[i] != 0.0f){
+                INSTR_FIM(FASE_VARREDURA);
+                fprintf(stderr, "No solution.\n");
+                return -2;
+            }
+            novo = (b[i] - sum) / a[i][i];
+            if (fabsf(novo - curr[i]) > diff)
+                diff = fabsf(novo - curr[i]);
+            curr[i] = novo;
+        }
+        INSTR_FIM(FASE_VARREDURA);
+
+        INSTR_INICIO(FASE_CONVERGENCIA);
+        int invalido = vetor_invalido(curr, N);
+        INSTR_FIM(FASE_CONVERGENCIA);
+        if (invalido){
+            fprintf(stderr, "Gauss-Seidel floating point error.\n");
+            return -3;
+        }
+    }
+
+    memcpy(x, curr, sizeof(real_t) * N);
+    return iter;
+}
+
+
+#define INSTANCIA(N) \
+    static int gauss##N (SistLinear_t *SL, real_t *x) { return gaussN(N, SL, x); } \
+    static int jacobi##N (SistLinear_t *SL, real_t *x) { return jacobiN(N, SL, x); } \
+    static int seidel##N (SistLinear_t *SL, real_t *x) { return seidelN(N, SL, x); }
+
+INSTANCIA(2)
+INSTANCIA(3)
+INSTANCIA(4)
+INSTANCIA(5)
+INSTANCIA(6)
+INSTANCIA(7)
+INSTANCIA(8)
+
+typedef int (*metodoPequeno_t)(SistLinear_t *SL, real_t *x);
+
+static const metodoPequeno_t gaussPequeno[PEQUENO_MAX + 1] = {
+    [2] = gauss2, [3] = gauss3, [4] = gauss4, [5] = gauss5, [6] = gauss6, [7] = gauss7, [8] = gauss8
+};
+
+static const metodoPequeno_t jacobiPequeno[PEQUENO_MAX + 1] = {
+    [2] = jacobi2, [3] = jacobi3, [4] = jacobi4, [5] = jacobi5, [6] = jacobi6, [7] = jacobi7, [8] = jacobi8
+};
+
+static const metodoPequeno_t seidelPequeno[PEQUENO_MAX + 1] = {
+    [2] = seidel2, [3] = seidel3, [4] = seidel4, [5] = seidel5, [6] = seidel6, [7] = seidel7, [8] = seidel8
+};
+
+
+// Eliminação de Gauss com pivoteamento parcial para n em [PEQUENO_MIN, PEQUENO_MAX]
+int eliminacaoGaussPequeno (SistLinear_t *SL, real_t *x)
+{
+    return gaussPequeno[SL->n](SL, x);
+}
+
+
+// Método de Jacobi para n em [PEQUENO_MIN, PEQUENO_MAX]
+int gaussJacobiPequeno (SistLinear_t *SL, real_t *x)
+{
+    return jacobiPequeno[SL->n](SL, x);
+}
+
+
+// Método de Gauss-Seidel para n em [PEQUENO_MIN, PEQUENO_MAX]
+int gaussSeidelPequeno (SistLinear_t *SL, real_t *x)
+{
+    return seidelPequeno[SL->n](SL, x);
+}
@@ -0,0 +1,19 @@
+#ifndef __SISPEQUENOS_H__
+#define __SISPEQUENOS_H__
+
+#include "SistemasLineares.h"
+
+// Tamanhos com métodos especializados, totalmente desenrolados e sem alocação
+#define PEQUENO_MIN 2
+#define PEQUENO_MAX 8
+
+// Verifica se há versão especializada para o tamanho do SL
+#define SL_PEQUENO(SL) ((SL)->n >= PEQUENO_MIN && (SL)->n <= PEQUENO_MAX)
+
+// Mesma semântica e códigos de retorno de eliminacaoGauss, gaussJacobi e
+// gaussSeidel (sem o teste de convergência e sem medir tempo). Exigem SL_PEQUENO(SL)
+int eliminacaoGaussPequeno (SistLinear_t *SL, real_t *x);
+int gaussJacobiPequeno (SistLinear_t *SL, real_t *x);
+int gaussSeidelPequeno (SistLinear_t *SL, real_t *x);
+
+#endif // __SISPEQUENOS_H__
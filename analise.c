@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <math.h>
+
+#include "utils.h"
+#include "analise.h"
+#include "SistemasPequenos.h"
+
+/*  Custo estimado: a eliminação faz cerca de 2n³/3 operações (2n·kl·(kl+ku)
+    em banda); um método
+    iterativo faz 2nnz por varredura e é limitado a MAXIT varreduras. Um
+    método iterativo só é escolhido quando MAXIT varreduras custam menos que
+    a eliminação e a estrutura de A garante (ou torna provável) a convergência.
+*/
+
+static const char *nomes[] = {
+    [METODO_NENHUM] = "Nenhum",
+    [METODO_GAUSS] = "Eliminação de Gauss",
+    [METODO_JACOBI] = "Jacobi",
+    [METODO_SEIDEL] = "Gauss-Seidel",
+    [METODO_GC] = "Gradiente Conjugado",
+    [METODO_GMRES] = "GMRES"
+};
+
+
+const char *nomeMetodo (Metodo_t m)
+{
+    return nomes[m];
+}
+
+
+void analisaSistLinear (SistLinear_t *SL, AnaliseSL_t *R)
+{
+    unsigned int n = SL->n, i, j;
+
+    R->n = n;
+    R->nnz = 0;
+    R->kl = R->ku = 0;
+    R->diagPositiva = 1;
+    for (i = 0; i < n; i++){
+        for (j = 0; j < n; j++)
+            if (SL->A[i][j] != 0.0f){
+                R->nnz++;
+                if (i > j && i - j > R->kl)
+                    R->kl = i - j;
+                if (j > i && j - i > R->ku)
+                    R->ku = j - i;
+            }
+        if (!(SL->A[i][i] > 0.0f))
+            R->diagPositiva = 0;
+    }
+    R->densidade = n ? (double) R->nnz / ((double) n * n) : 0.0;
+
+    R->dominante = jacobi_converge(SL);
+    R->sassenfeld = R->dominante || seidel_converge(SL);
+    R->simetrica = simetrica(SL);
+
+    // Em banda, eliminacaoGauss fatora só a banda (ver SistemasBanda.h)
+    int banda = 2 * (R->kl + R->ku) < n;
+    double eliminacao = banda ? 2.0 * n * R->kl * (R->kl + R->ku + 1) : 2.0 * n * n * n / 3.0;
+    double iterativo = 2.0 * R->nnz * MAXIT;
+
+    if (SL_PEQUENO(SL)){
+        R->metodo = METODO_GAUSS;
+        R->reserva = METODO_NENHUM;
+        snprintf(R->motivo, ANALISE_MOTIVO, "n = %u: eliminação desenrolada para n pequeno", n);
+    }
+    else if (banda && iterativo >= eliminacao){
+        R->metodo = METODO_GAUSS;
+        R->reserva = METODO_NENHUM;
+        snprintf(R->motivo, ANALISE_MOTIVO, "banda %u/%u: %s em O(n·bw²)",
+                 R->kl, R->ku, R->kl <= 1 && R->ku <= 1 ? "algoritmo de Thomas ou LU em banda" : "LU em banda");
+    }
+    else if (iterativo >= eliminacao){
+        R->metodo = METODO_GAUSS;
+        R->reserva = R->sassenfeld ? METODO_SEIDEL : (R->simetrica && R->diagPositiva) ? METODO_GC : METODO_GMRES;
+        snprintf(R->motivo, ANALISE_MOTIVO, "densidade %.2f: %d varreduras (%.3g operações) custam mais que a eliminação (%.3g)",
+                 R->densidade, MAXIT, iterativo, eliminacao);
+    }
+    else if (R->simetrica && R->diagPositiva){
+        R->metodo = METODO_GC;
+        R->reserva = METODO_GAUSS;
+        snprintf(R->motivo, ANALISE_MOTIVO, "simétrica com diagonal positiva, densidade %.2f, banda %u/%u",
+                 R->densidade, R->kl, R->ku);
+    }
+    else if (R->sassenfeld){
+        R->metodo = METODO_SEIDEL;
+        R->reserva = METODO_GAUSS;
+        snprintf(R->motivo, ANALISE_MOTIVO, "%s, densidade %.2f, banda %u/%u",
+                 R->dominante ? "diagonal dominante" : "critério de Sassenfeld satisfeito",
+                 R->densidade, R->kl, R->ku);
+    }
+    else {
+        R->metodo = METODO_GMRES;
+        R->reserva = METODO_GAUSS;
+        snprintf(R->motivo, ANALISE_MOTIVO, "não simétrica e sem convergência garantida por Jacobi/Seidel, densidade %.2f, banda %u/%u",
+                 R->densidade, R->kl, R->ku);
+    }
+}
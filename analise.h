@@ -0,0 +1,39 @@
+#ifndef __ANALISE_H__
+#define __ANALISE_H__
+
+#include "SistemasLineares.h"
+
+#define ANALISE_MOTIVO 160  // Tamanho do texto com a justificativa da escolha
+
+// Métodos que a análise pode escolher
+typedef enum {
+  METODO_NENHUM,
+  METODO_GAUSS,
+  METODO_JACOBI,
+  METODO_SEIDEL,
+  METODO_GC,
+  METODO_GMRES
+} Metodo_t;
+
+// Estrutura de A medida por analisaSistLinear
+typedef struct {
+  unsigned int n; // tamanho do SL
+  unsigned int nnz; // coeficientes não nulos
+  double densidade; // nnz / n²
+  unsigned int kl, ku; // maior distância de um não nulo abaixo/acima da diagonal
+  int dominante; // critério das linhas (jacobi_converge)
+  int sassenfeld; // critério de Sassenfeld (seidel_converge)
+  int simetrica; // A simétrica
+  int diagPositiva; // todos os coeficientes diagonais positivos
+  Metodo_t metodo; // método escolhido
+  Metodo_t reserva; // usado se o escolhido falhar
+  char motivo[ANALISE_MOTIVO]; // por que 'metodo' foi escolhido
+} AnaliseSL_t;
+
+// Mede a estrutura de SL e escolhe o método de menor custo esperado e uma reserva
+void analisaSistLinear (SistLinear_t *SL, AnaliseSL_t *R);
+
+// Nome do método, como impresso pelo programa principal
+const char *nomeMetodo (Metodo_t m);
+
+#endif // __ANALISE_H__
@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "arena.h"
+
+/*  A área é uma lista de blocos alinhados. Os blocos depois do corrente estão
+    sempre vazios; quando uma reserva não cabe no corrente, passa-se ao
+    próximo (criado se preciso, com pelo menos o dobro do tamanho). Como os
+    blocos nunca mudam de lugar, ponteiros já entregues continuam válidos.
+    Quando a área volta a ficar vazia, os blocos são fundidos num só, com a
+    soma dos tamanhos, para que o próximo sistema caiba num único bloco.
+*/
+
+typedef struct BlocoArena {
+    struct BlocoArena *prox;
+    size_t tamanho, usado;
+} BlocoArena_t;
+
+#define ARREDONDA(x) (((x) + ARENA_ALINHAMENTO - 1) & ~((size_t) ARENA_ALINHAMENTO - 1))
+#define CABECALHO ARREDONDA(sizeof(BlocoArena_t))
+
+static __thread BlocoArena_t *primeiro = NULL, *atual = NULL;
+
+
+static BlocoArena_t *novoBloco (size_t tamanho)
+{
+    BlocoArena_t *b = aligned_alloc(ARENA_ALINHAMENTO, CABECALHO + tamanho);
+    must_alloc(b, __func__);
+    b->prox = NULL;
+    b->tamanho = tamanho;
+    b->usado = 0;
+    return b;
+}
+
+
+void *arenaAloca (size_t bytes)
+{
+    bytes = ARREDONDA(bytes ? bytes : 1);
+
+    if (!atual){
+        if (!primeiro)
+            primeiro = novoBloco(bytes > ARENA_BLOCO_MIN ? bytes : ARENA_BLOCO_MIN);
+        atual = primeiro;
+    }
+
+    while (atual->usado + bytes > atual->tamanho){
+        if (!atual->prox)
+            atual->prox = novoBloco(bytes > 2 * atual->tamanho ? bytes : 2 * atual->tamanho);
+        atual = atual->prox;
+    }
+
+    void *p = (unsigned char*) atual + CABECALHO + atual->usado;
+    atual->usado += bytes;
+    return p;
+}
+
+
+void *arenaZera (size_t bytes)
+{
+    void *p = arenaAloca(bytes);
+    memset(p, 0, bytes);
+    return p;
+}
+
+
+MarcaArena_t arenaMarca (void)
+{
+    MarcaArena_t m = { atual, atual ? atual->usado : 0 };
+    return m;
+}
+
+
+void arenaRetorna (MarcaArena_t m)
+{
+    BlocoArena_t *b = m.bloco ? m.bloco : primeiro;
+    if (!b)
+        return;
+
+    for (BlocoArena_t *c = b->prox; c; c = c->prox)
+        c->usado = 0;
+    b->usado = m.usado;
+    atual = b;
+
+    if (b == primeiro && b->usado == 0 && b->prox){
+        size_t total = 0;
+        while (primeiro){
+            BlocoArena_t *c = primeiro;
+            total += c->tamanho;
+            primeiro = c->prox;
+            free(c);
+        }
+        primeiro = atual = novoBloco(total);
+    }
+}
+
+
+void arenaDescarta (void)
+{
+    while (primeiro){
+        BlocoArena_t *c = primeiro;
+        primeiro = c->prox;
+        free(c);
+    }
+    atual = NULL;
+}
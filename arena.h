@@ -0,0 +1,32 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <stddef.h>
+
+#define ARENA_ALINHAMENTO 64  // Alinhamento de cada reserva (uma linha de cache)
+#define ARENA_BLOCO_MIN ((size_t) 1 << 20)  // Tamanho do primeiro bloco da área
+
+/*  Área de trabalho dos métodos, uma por thread. As reservas são feitas em
+    pilha: arenaMarca guarda a posição atual e arenaRetorna descarta tudo o que
+    foi reservado depois dela. A memória nunca é devolvida ao sistema durante
+    a execução; depois do primeiro sistema de cada tamanho, resolver outro de
+    mesmo tamanho não faz nenhuma alocação.
+*/
+typedef struct {
+  void *bloco; // bloco corrente no momento da marca
+  size_t usado; // bytes usados desse bloco
+} MarcaArena_t;
+
+// Reserva 'bytes' na área da thread. Nunca retorna NULL
+void *arenaAloca (size_t bytes);
+
+// Como arenaAloca, com a memória zerada
+void *arenaZera (size_t bytes);
+
+MarcaArena_t arenaMarca (void);
+void arenaRetorna (MarcaArena_t m);
+
+// Libera a área da thread (fim da thread ou do programa)
+void arenaDescarta (void);
+
+#endif // __ARENA_H__
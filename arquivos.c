@@ -0,0 +1,336 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "utils.h"
+#include "arquivos.h"
+#include "SistemasBanda.h"
+
+#define BUF_TAM (1 << 20)  // Tamanho do buffer de leitura
+
+static char buf[BUF_TAM];
+static size_t buf_pos = 0, buf_fim = 0;
+
+
+// Retorna o próximo caractere da entrada sem consumi-lo, ou EOF
+static inline int espia (void)
+{
+    if (buf_pos == buf_fim){
+        buf_fim = fread(buf, 1, BUF_TAM, stdin);
+        buf_pos = 0;
+        if (buf_fim == 0)
+            return EOF;
+    }
+    return (unsigned char) buf[buf_pos];
+}
+
+
+static inline int ehEspaco (int c)
+{
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+}
+
+
+int fimEntrada (void)
+{
+    int c;
+    while ((c = espia()) != EOF && ehEspaco(c))
+        buf_pos++;
+    return c == EOF;
+}
+
+
+int leInteiro (unsigned int *v)
+{
+    if (fimEntrada())
+        return 0;
+
+    unsigned int r = 0;
+    int c, lidos = 0;
+    while ((c = espia()) >= '0' && c <= '9'){
+        r = r * 10 + (c - '0');
+        buf_pos++;
+        lidos++;
+    }
+    *v = r;
+    return lidos > 0;
+}
+
+
+int leInteiroNaLinha (unsigned int *v)
+{
+    int c;
+    while ((c = espia()) == ' ' || c == '\t' || c == '\r')
+        buf_pos++;
+    if (c < '0' || c > '9')
+        return 0;
+    return leInteiro(v);
+}
+
+
+// Maior token (com o '\0') convertido por strtof em leReal
+#define TAM_TOKEN 64
+
+// Potências de 10 exatamente representáveis em double
+static const double pot10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+
+// Acrescenta c ao token de leReal; 't' conta também os caracteres que não couberam
+static inline void acrescenta (char *token, size_t *t, int c){
+    if (*t < TAM_TOKEN - 1)
+        token[*t] = c;
+    (*t)++;
+}
+
+
+/*  Converte "[sinal]dígitos[.dígitos][e[sinal]dígitos]". A mantissa é acumulada
+    em inteiro de 64 bits (até 19 dígitos significativos) e escalada por uma
+    única potência de 10. Qualquer outra forma (nan, inf, hexadecimal) cai
+    para strtof
+*/
+int leReal (real_t *v)
+{
+    if (fimEntrada())
+        return 0;
+
+    char token[TAM_TOKEN];
+    size_t t = 0;
+    uint64_t mant = 0;
+    int exp = 0, neg = 0, digitos = 0, lidos = 0, c;
+
+    c = espia();
+    if (c == '-' || c == '+'){
+        neg = (c == '-');
+        token[t++] = c;
+        buf_pos++;
+    }
+
+    while ((c = espia()) >= '0' && c <= '9'){
+        if (digitos < 19)
+            mant = mant * 10 + (c - '0');
+        else
+            exp++;
+        if (mant) digitos++;
+        acrescenta(token, &t, c);
+        buf_pos++;
+        lidos++;
+    }
+
+    if (c == '.'){
+        acrescenta(token, &t, c);
+        buf_pos++;
+        while ((c = espia()) >= '0' && c <= '9'){
+            if (digitos < 19){
+                mant = mant * 10 + (c - '0');
+                exp--;
+            }
+            if (mant) digitos++;
+            acrescenta(token, &t, c);
+            buf_pos++;
+            lidos++;
+        }
+    }
+
+    if (lidos == 0 || !(c == EOF || ehEspaco(c) || c == 'e' || c == 'E')){
+        // Forma não reconhecida: lê o token inteiro e usa strtof
+        while ((c = espia()) != EOF && !ehEspaco(c)){
+            acrescenta(token, &t, c);
+            buf_pos++;
+        }
+        if (t >= TAM_TOKEN) // não cabe: rejeita em vez de converter só o início
+            return 0;
+        token[t] = '\0';
+        char *fim;
+        *v = strtof(token, &fim);
+        return fim != token;
+    }
+
+    if (c == 'e' || c == 'E'){
+        int e = 0, eneg = 0;
+        buf_pos++;
+        c = espia();
+        if (c == '-' || c == '+'){
+            eneg = (c == '-');
+            buf_pos++;
+        }
+        while ((c = espia()) >= '0' && c <= '9'){
+            if (e < 10000)
+                e = e * 10 + (c - '0');
+            buf_pos++;
+        }
+        exp += eneg ? -e : e;
+    }
+
+    double r = (double) mant;
+    if (exp >= 0)
+        r = (exp <= 22) ? r * pot10[exp] : r * pow(10.0, exp);
+    else
+        r = (exp >= -22) ? r / pot10[-exp] : r * pow(10.0, exp);
+
+    *v = (real_t) (neg ? -r : r);
+    return 1;
+}
+
+
+/*!
+  \brief Escreve um SL no formato binário
+
+  \param f arquivo de saída
+  \param SL Ponteiro para o sistema linear
+
+  \return código de erro. 0 em caso de sucesso.
+  */
+int escreveSistLinearBin (FILE *f, SistLinear_t *SL)
+{
+    CabecalhoBin_t cab;
+    memcpy(cab.assinatura, BIN_ASSINATURA, 4);
+    cab.n = SL->n;
+    cab.erro = SL->erro;
+    cab.nrhs = SL->nrhs;
+
+    if (fwrite(&cab, sizeof(cab), 1, f) != 1)
+        return -1;
+    for (unsigned int i = 0; i < SL->n; i++)
+        if (fwrite(SL->A[i], sizeof(real_t), SL->n, f) != SL->n)
+            return -1;
+    size_t nb = (size_t) SL->n * SL->nrhs;
+    if (fwrite(SL->b, sizeof(real_t), nb, f) != nb)
+        return -1;
+    return 0;
+}
+
+
+/*!
+  \brief Lê um SL no formato binário
+
+  \param f arquivo de entrada
+
+  \return sistema linear SL. NULL no fim do arquivo ou se houve erro
+  */
+SistLinear_t *lerSistLinearBin (FILE *f)
+{
+    CabecalhoBin_t cab;
+    if (fread(&cab, sizeof(cab), 1, f) != 1)
+        return NULL;
+    if (memcmp(cab.assinatura, BIN_ASSINATURA, 4)){
+        fprintf(stderr, "Invalid binary system header.\n");
+        return NULL;
+    }
+
+    SistLinear_t *SL = alocaSistLinearMultiplo(cab.n, cab.nrhs ? cab.nrhs : 1);
+    SL->erro = cab.erro;
+    for (unsigned int i = 0; i < SL->n; i++)
+        if (fread(SL->A[i], sizeof(real_t), SL->n, f) != SL->n){
+            liberaSistLinear(SL);
+            return NULL;
+        }
+    size_t nb = (size_t) SL->n * SL->nrhs;
+    if (fread(SL->b, sizeof(real_t), nb, f) != nb){
+        liberaSistLinear(SL);
+        return NULL;
+    }
+    detectaBanda(SL);
+    return SL;
+}
+
+
+/*!
+  \brief Mapeia em memória um arquivo de sistemas no formato binário
+
+  \param arquivo caminho do arquivo
+
+  \return mapeamento. NULL se o arquivo não pôde ser aberto ou mapeado
+  */
+MapaSL_t *mapeiaSistemas (const char *arquivo)
+{
+    int fd = open(arquivo, O_RDONLY);
+    if (fd < 0){
+        perror(arquivo);
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size == 0){
+        close(fd);
+        return NULL;
+    }
+
+    // Privado e com escrita: os métodos não alteram o SL, mas uma escrita
+    // acidental não corrompe o arquivo
+    void *base = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED){
+        perror(arquivo);
+        return NULL;
+    }
+    madvise(base, st.st_size, MADV_SEQUENTIAL);
+
+    MapaSL_t *M = malloc(sizeof(MapaSL_t));
+    must_alloc(M, __func__);
+    M->base = base;
+    M->tamanho = st.st_size;
+    M->pos = 0;
+
+    return M;
+}
+
+
+void desmapeiaSistemas (MapaSL_t *M)
+{
+    munmap(M->base, M->tamanho);
+    free(M);
+}
+
+
+SistLinear_t *proximoMapeado (MapaSL_t *M)
+{
+    CabecalhoBin_t cab;
+    if (M->pos + sizeof(cab) > M->tamanho)
+        return NULL;
+
+    memcpy(&cab, M->base + M->pos, sizeof(cab));
+    if (cab.nrhs == 0)
+        cab.nrhs = 1;
+    size_t dados = ((size_t) cab.n * cab.n + (size_t) cab.n * cab.nrhs) * sizeof(real_t);
+    if (memcmp(cab.assinatura, BIN_ASSINATURA, 4) || M->pos + sizeof(cab) + dados > M->tamanho){
+        fprintf(stderr, "Invalid binary system at offset %zu.\n", M->pos);
+        return NULL;
+    }
+
+    SistLinear_t *SL = malloc(sizeof(SistLinear_t));
+    must_alloc(SL, __func__);
+    SL->n = cab.n;
+    SL->nrhs = cab.nrhs;
+    SL->erro = cab.erro;
+
+    SL->A = malloc(SL->n * sizeof(real_t*));
+    must_alloc(SL->A, __func__);
+
+    // Visão sem cópia: as linhas ficam como no arquivo, sem alinhamento nem folga
+    real_t *A = (real_t*) (M->base + M->pos + sizeof(cab));
+    SL->lda = SL->n;
+    for (unsigned int i = 0; i < SL->n; i++)
+        SL->A[i] = A + (size_t) i * SL->n;
+    SL->b = A + (size_t) SL->n * SL->n;
+    SL->perm = NULL;
+    detectaBanda(SL);
+
+    M->pos += sizeof(cab) + dados;
+    return SL;
+}
+
+
+// Libera um SL obtido de proximoMapeado (os dados pertencem ao mapeamento)
+void liberaVisaoSL (SistLinear_t *SL)
+{
+    free(SL->A);
+    free(SL);
+}
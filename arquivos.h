@@ -0,0 +1,52 @@
+#ifndef __ARQUIVOS_H__
+#define __ARQUIVOS_H__
+
+#include <stdio.h>
+#include <stdint.h>
+#include "SistemasLineares.h"
+
+// Leitura bufferizada da entrada padrão, usada no lugar de fscanf
+
+// Lê o próximo número da entrada. Retorna 0 se não havia número a ler
+int leInteiro (unsigned int *v);
+int leReal (real_t *v);
+
+// Como leInteiro, mas só lê o número se ele estiver na linha atual
+int leInteiroNaLinha (unsigned int *v);
+
+// Descarta espaços em branco e verifica se a entrada terminou
+int fimEntrada (void);
+
+
+// Formato binário: sistemas concatenados, cada um com um cabeçalho seguido
+// de A (n*n real_t, linha a linha) e b (n*nrhs real_t, coluna a coluna),
+// sem separadores
+#define BIN_ASSINATURA "SLB1"
+
+typedef struct {
+  char assinatura[4]; // BIN_ASSINATURA
+  uint32_t n; // tamanho do SL
+  real_t erro; // critério de parada
+  uint32_t nrhs; // número de colunas de b (0 em arquivos antigos equivale a 1)
+} CabecalhoBin_t;
+
+// Escreve/lê um SL no formato binário. A leitura retorna NULL no fim do arquivo
+int escreveSistLinearBin (FILE *f, SistLinear_t *SL);
+SistLinear_t *lerSistLinearBin (FILE *f);
+
+// Arquivo binário mapeado em memória
+typedef struct {
+  unsigned char *base; // início do mapeamento
+  size_t tamanho; // tamanho do arquivo
+  size_t pos; // posição do próximo sistema
+} MapaSL_t;
+
+MapaSL_t *mapeiaSistemas (const char *arquivo);
+void desmapeiaSistemas (MapaSL_t *M);
+
+// Próximo sistema do mapeamento, sem cópia: A e b apontam para o arquivo.
+// Retorna NULL no fim. Deve ser liberado com liberaVisaoSL
+SistLinear_t *proximoMapeado (MapaSL_t *M);
+void liberaVisaoSL (SistLinear_t *SL);
+
+#endif // __ARQUIVOS_H__
@@ -0,0 +1,331 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "utils.h"
+#include "arena.h"
+#include "SistemasLineares.h"
+#include "SistemasEsparsos.h"
+#include "SistemasBanda.h"
+#include "cacheLU.h"
+#include "geradores.h"
+
+#define BENCH_MAX_REPETICOES 1000
+
+typedef enum { BENCH_GAUSS, BENCH_JACOBI, BENCH_SEIDEL, BENCH_GC,
+               BENCH_JACOBI_CSR, BENCH_SEIDEL_CSR, BENCH_GMRES, BENCH_NUM } MetodoBench_t;
+
+// Os métodos até BENCH_GC usam a matriz densa; os demais, o sistema em CSR
+#define BENCH_DENSO(m) ((m) <= BENCH_GC)
+
+static const char *nomesMetodos[BENCH_NUM] = { "gauss", "jacobi", "seidel", "gc", "jacobi-csr", "seidel-csr", "gmres" };
+
+// Métodos medidos quando -m não é dado: os que fazem sentido para cada família
+static const int adequado[FAMILIA_NUM][BENCH_NUM] = {
+    [FAMILIA_DENSA]       = { 1, 0, 0, 0, 0, 0, 0 },
+    [FAMILIA_DOMINANTE]   = { 1, 1, 1, 0, 0, 0, 0 },
+    [FAMILIA_SPD]         = { 1, 1, 1, 1, 0, 0, 0 },
+    [FAMILIA_TRIDIAGONAL] = { 1, 0, 0, 0, 1, 1, 1 },
+    [FAMILIA_POISSON]     = { 1, 0, 0, 1, 1, 1, 1 },
+};
+
+typedef struct {
+    unsigned int nmin, nmax;
+    int repeticoes, aquecimento;
+    double limite; // tempo medido máximo por caso (ms)
+    uint64_t semente;
+    int json;
+    int familias[FAMILIA_NUM], metodos[BENCH_NUM]; // selecionados (metodos todos 0: adequados)
+} Bench_t;
+
+// Um sistema gerado, nas representações usadas pelos métodos selecionados
+typedef struct {
+    unsigned int n;
+    unsigned long nnz;
+    SistLinear_t *SL; // NULL se nenhum método denso foi selecionado
+    SistLinearCSR_t *CSR; // NULL se nenhum método em CSR foi selecionado
+} Caso_t;
+
+
+static int executa (MetodoBench_t m, Caso_t *C, real_t *x){
+    double t;
+    memset(x, 0, sizeof(real_t) * C->n); // cada execução parte de zero, não da anterior
+    switch (m){
+        case BENCH_GAUSS: return eliminacaoGauss(C->SL, x, &t);
+        case BENCH_JACOBI: return gaussJacobi(C->SL, x, &t);
+        case BENCH_SEIDEL: return gaussSeidel(C->SL, x, &t);
+        case BENCH_GC: return gradienteConjugado(C->SL, x, &t);
+        case BENCH_JACOBI_CSR: return gaussJacobiCSR(C->CSR, x, &t);
+        case BENCH_SEIDEL_CSR: return gaussSeidelCSR(C->CSR, x, &t);
+        case BENCH_GMRES: return gmresCSR(C->CSR, x, &t);
+        default: return -1;
+    }
+}
+
+
+// Jacobi, Gauss-Seidel e o gradiente conjugado param no limite de iterações
+// sem relatar erro; atingi-lo conta como não convergido. O GMRES retorna erro
+static int convergiu (MetodoBench_t m, int iter){
+    switch (m){
+        case BENCH_JACOBI:
+        case BENCH_SEIDEL:
+        case BENCH_JACOBI_CSR:
+        case BENCH_SEIDEL_CSR:
+            return iter < MAXIT;
+        case BENCH_GC:
+            return iter < MAXIT_GC;
+        default:
+            return 1;
+    }
+}
+
+
+/*  Operações de ponto flutuante e bytes mínimos de memória de uma execução,
+    pelos mesmos modelos de custo de analisaSistLinear. Métodos iterativos
+    densos percorrem a matriz inteira a cada iteração, e os em CSR só os nnz
+    coeficientes; para o GMRES, cada iteração conta o produto por A e a
+    aplicação do ILU(0) (2 nnz cada) e, em média, GMRES_M/2 + 1 vetores da
+    ortogonalização
+*/
+static void custo (MetodoBench_t m, Caso_t *C, int iter, double *flops, double *bytes){
+    double n = C->n, nnz = C->nnz, a = sizeof(real_t), c = sizeof(unsigned int);
+
+    switch (m){
+        case BENCH_GAUSS:
+            if (SL_BANDA(C->SL)){
+                double kl = C->SL->kl, ku = C->SL->ku;
+                *flops = 2.0 * n * kl * (kl + ku + 1) + 2.0 * n * (2 * kl + ku + 1);
+                *bytes = 2.0 * n * (2 * kl + ku + 1) * a;
+            }
+            else {
+                *flops = 2.0 * n * n * n / 3.0 + 2.0 * n * n;
+                *bytes = 2.0 * n * n * a;
+            }
+            break;
+        case BENCH_JACOBI:
+        case BENCH_SEIDEL:
+            *flops = iter * 2.0 * n * n;
+            *bytes = iter * (n * n + 2.0 * n) * a;
+            break;
+        case BENCH_GC:
+            *flops = iter * (2.0 * n * n + 12.0 * n);
+            *bytes = iter * (n * n + 6.0 * n) * a;
+            break;
+        case BENCH_JACOBI_CSR:
+        case BENCH_SEIDEL_CSR:
+            *flops = iter * 2.0 * nnz;
+            *bytes = iter * (nnz * (a + c) + 2.0 * n * a);
+            break;
+        case BENCH_GMRES:
+            *flops = iter * (4.0 * nnz + 4.0 * n * (GMRES_M / 2 + 1));
+            *bytes = iter * (2.0 * nnz * (a + c) + n * (GMRES_M / 2 + 1) * sizeof(double));
+            break;
+        default:
+            *flops = *bytes = 0.0;
+    }
+}
+
+
+static int compara (const void *a, const void *b){
+    double x = *(const double*) a, y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+
+// Mede um método num sistema e escreve uma linha do relatório. Retorna 0 se mediu.
+// Execuções que atingem o limite de iterações são relatadas com convergiu = 0
+static int mede (Bench_t *B, MetodoBench_t m, Familia_t f, Caso_t *C, int *primeiro){
+    double tempos[BENCH_MAX_REPETICOES], total = 0.0, t;
+    int k, iter = 0;
+
+    MarcaArena_t marca = arenaMarca();
+    real_t *x = arenaAloca(sizeof(real_t) * C->n);
+
+    for (k = 0; k < B->aquecimento; k++)
+        if ((iter = executa(m, C, x)) < 0){
+            fprintf(stderr, "%s %s n=%u: falhou (%d)\n", nomeFamilia(f), nomesMetodos[m], C->n, iter);
+            arenaRetorna(marca);
+            return -1;
+        }
+
+    // Pelo menos uma repetição; as demais enquanto couberem no limite de tempo
+    for (k = 0; k < B->repeticoes && (k == 0 || total < B->limite); k++){
+        t = timestamp();
+        iter = executa(m, C, x);
+        tempos[k] = timestamp() - t;
+        total += tempos[k];
+        if (iter < 0){
+            fprintf(stderr, "%s %s n=%u: falhou (%d)\n", nomeFamilia(f), nomesMetodos[m], C->n, iter);
+            arenaRetorna(marca);
+            return -1;
+        }
+    }
+    arenaRetorna(marca);
+
+    qsort(tempos, k, sizeof(double), compara);
+    double mediana = k % 2 ? tempos[k / 2] : (tempos[k / 2 - 1] + tempos[k / 2]) / 2.0;
+    double p95 = tempos[(95 * k + 99) / 100 - 1]; // posição ceil(0,95 k)
+
+    double flops, bytes;
+    custo(m, C, m == BENCH_GAUSS ? 1 : iter, &flops, &bytes);
+    double gflops = flops / (mediana * 1e6), gbs = bytes / (mediana * 1e6);
+    int conv = convergiu(m, iter);
+    if (m == BENCH_GAUSS)
+        iter = 0;
+
+    if (B->json)
+        printf("%s  {\"familia\": \"%s\", \"metodo\": \"%s\", \"n\": %u, \"nnz\": %lu, \"repeticoes\": %d, "
+               "\"iteracoes\": %d, \"convergiu\": %s, \"mediana_ms\": %.6f, \"p95_ms\": %.6f, \"gflops\": %.4f, \"gbs\": %.4f}",
+               *primeiro ? "" : ",\n", nomeFamilia(f), nomesMetodos[m], C->n, C->nnz, k,
+               iter, conv ? "true" : "false", mediana, p95, gflops, gbs);
+    else
+        printf("%s,%s,%u,%lu,%d,%d,%d,%.6f,%.6f,%.4f,%.4f\n", nomeFamilia(f), nomesMetodos[m], C->n, C->nnz, k,
+               iter, conv, mediana, p95, gflops, gbs);
+    fflush(stdout);
+    *primeiro = 0;
+
+    return 0;
+}
+
+
+// Marca em 'sel' os itens de 'lista' (separados por vírgula). Retorna -1 se algum não existe
+static int selecao (char *lista, const char **nomes, int num, int *sel){
+    for (char *item = strtok(lista, ","); item; item = strtok(NULL, ",")){
+        int i;
+        for (i = 0; i < num && strcmp(item, nomes[i]); i++);
+        if (i == num){
+            fprintf(stderr, "Desconhecido: %s\n", item);
+            return -1;
+        }
+        sel[i] = 1;
+    }
+    return 0;
+}
+
+
+/*  Mede os métodos em sistemas gerados (ver geradores.h), dobrando n a cada
+    passo, e escreve um caso por linha em CSV (padrão) ou JSON. O cache de
+    fatorações fica desativado, para que cada repetição fatore a matriz. A
+    matriz densa só é gerada se algum método denso foi selecionado; a
+    conversão para CSR é feita antes das medições.
+    Opções:
+    -n N  menor ordem (padrão 4)
+    -N N  maior ordem (padrão 8192)
+    -f L  famílias, separadas por vírgula: densa,dominante,spd,tridiagonal,poisson (padrão todas)
+    -m L  métodos: gauss,jacobi,seidel,gc (densos), jacobi-csr,seidel-csr,gmres (CSR)
+          (padrão os adequados a cada família)
+    -r R  repetições medidas (padrão 5)
+    -w W  execuções de aquecimento, não medidas (padrão 1)
+    -T ms tempo medido máximo por caso; repetições além dele são omitidas (padrão 2000)
+    -s S  semente dos geradores (padrão 1)
+    -t N  número de threads dos métodos paralelos
+    -j    saída em JSON
+*/
+int main (int argc, char **argv){
+    Bench_t B = { 4, 8192, 5, 1, 2000.0, 1, 0, { 0 }, { 0 } };
+    int opt, familias = 0;
+
+    const char *nomesFamilias[FAMILIA_NUM];
+    for (int f = 0; f < FAMILIA_NUM; f++)
+        nomesFamilias[f] = nomeFamilia(f);
+
+    while ((opt = getopt(argc, argv, "n:N:f:m:r:w:T:s:t:j")) != -1){
+        switch (opt){
+            case 'n': B.nmin = atoi(optarg); break;
+            case 'N': B.nmax = atoi(optarg); break;
+            case 'f':
+                if (selecao(optarg, nomesFamilias, FAMILIA_NUM, B.familias))
+                    return -1;
+                familias = 1;
+                break;
+            case 'm':
+                if (selecao(optarg, nomesMetodos, BENCH_NUM, B.metodos))
+                    return -1;
+                break;
+            case 'r': B.repeticoes = atoi(optarg); break;
+            case 'w': B.aquecimento = atoi(optarg); break;
+            case 'T': B.limite = atof(optarg); break;
+            case 's': B.semente = strtoull(optarg, NULL, 10); break;
+            case 't': defineThreads(atoi(optarg)); break;
+            case 'j': B.json = 1; break;
+            default:
+                fprintf(stderr, "Uso: %s [-n min] [-N max] [-f familias] [-m metodos] [-r repeticoes] "
+                                "[-w aquecimento] [-T ms] [-s semente] [-t threads] [-j]\n", argv[0]);
+                return -1;
+        }
+    }
+    if (B.repeticoes < 1) B.repeticoes = 1;
+    if (B.repeticoes > BENCH_MAX_REPETICOES) B.repeticoes = BENCH_MAX_REPETICOES;
+    if (B.nmin < 1) B.nmin = 1;
+    if (!familias)
+        for (int f = 0; f < FAMILIA_NUM; f++)
+            B.familias[f] = 1;
+
+    int todos = 1;
+    for (int m = 0; m < BENCH_NUM; m++)
+        if (B.metodos[m])
+            todos = 0;
+
+    defineCacheLU(0);
+
+    int primeiro = 1;
+    unsigned int anterior[FAMILIA_NUM] = { 0 }; // última ordem medida de cada família
+    if (B.json)
+        printf("[\n");
+    else
+        printf("familia,metodo,n,nnz,repeticoes,iteracoes,convergiu,mediana_ms,p95_ms,gflops,gbs\n");
+
+    for (unsigned int n = B.nmin; n <= B.nmax; n *= 2){
+        for (int f = 0; f < FAMILIA_NUM; f++){
+            if (!B.familias[f])
+                continue;
+
+            int sel[BENCH_NUM], densos = 0, esparsos = 0;
+            for (int m = 0; m < BENCH_NUM; m++){
+                sel[m] = todos ? adequado[f][m] : B.metodos[m];
+                if (sel[m])
+                    BENCH_DENSO(m) ? (densos = 1) : (esparsos = 1);
+            }
+            if (!densos && !esparsos)
+                continue;
+
+            Caso_t C = { 0, 0, NULL, NULL };
+            if (densos)
+                C.SL = geraSistLinear(f, n, B.semente + n);
+            if (esparsos)
+                C.CSR = geraSistLinearCSR(f, n, B.semente + n);
+            C.n = C.SL ? C.SL->n : C.CSR->n;
+
+            if (C.n != anterior[f]){ // Poisson arredonda n para um quadrado
+                anterior[f] = C.n;
+
+                if (C.CSR)
+                    C.nnz = C.CSR->nnz;
+                else
+                    for (unsigned int i = 0; i < C.n; i++)
+                        for (unsigned int j = 0; j < C.n; j++)
+                            C.nnz += C.SL->A[i][j] != 0.0f;
+
+                for (int m = 0; m < BENCH_NUM; m++)
+                    if (sel[m]){
+                        fprintf(stderr, "%s %s n=%u\n", nomeFamilia(f), nomesMetodos[m], C.n);
+                        mede(&B, m, f, &C, &primeiro);
+                    }
+            }
+
+            if (C.SL)
+                liberaSistLinear(C.SL);
+            if (C.CSR)
+                liberaSistLinearCSR(C.CSR);
+        }
+        // Entradas de fatoração guardadas para reaproveitamento não servem para o próximo n
+        defineCacheLU(0);
+    }
+
+    if (B.json)
+        printf("\n]\n");
+
+    arenaDescarta();
+    return 0;
+}
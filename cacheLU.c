@@ -0,0 +1,276 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "utils.h"
+#include "cacheLU.h"
+
+/*  As entradas ficam numa tabela de dispersão, pela dispersão de A, e numa
+    lista duplamente encadeada em ordem de uso. Um acerto é confirmado com
+    memcmp, e a fatoração de uma falta é calculada fora da trava. Entradas
+    descartadas enquanto em uso são liberadas pelo último usuário. As últimas
+    CACHE_LU_RECICLA entradas liberadas são guardadas para reaproveitamento
+    numa falta de mesma ordem, de forma que resolver sistemas distintos do
+    mesmo tamanho (ou com o cache desativado) não aloca memória.
+*/
+
+static EntradaLU_t *tabela[CACHE_LU_BALDES];
+static EntradaLU_t *recente = NULL, *antiga = NULL;
+static EntradaLU_t *reciclagem = NULL; // entradas liberadas, encadeadas por 'prox'
+static int nreciclagem = 0;
+static size_t limite = CACHE_LU_LIMITE, ocupado = 0;
+static unsigned long acertos = 0, faltas = 0;
+static pthread_mutex_t trava = PTHREAD_MUTEX_INITIALIZER;
+
+
+// FNV-1a sobre os bits de cada elemento, linha a linha (sem a folga entre linhas)
+static uint64_t dispersao (SistLinear_t *SL)
+{
+    uint64_t h = 0xcbf29ce484222325ULL ^ ((uint64_t) SL->n * SL->n);
+    uint32_t w;
+
+    for (unsigned int i = 0; i < SL->n; i++)
+        for (unsigned int j = 0; j < SL->n; j++){
+            memcpy(&w, SL->A[i] + j, sizeof(w));
+            h ^= w;
+            h *= 0x100000001b3ULL;
+        }
+    return h;
+}
+
+
+// Compara a cópia compacta 'C' (n*n, linha a linha) com SL->A
+static int mesmaMatriz (const real_t *C, SistLinear_t *SL)
+{
+    for (unsigned int i = 0; i < SL->n; i++)
+        if (memcmp(C + (size_t) i * SL->n, SL->A[i], SL->n * sizeof(real_t)))
+            return 0;
+    return 1;
+}
+
+
+static void libera (EntradaLU_t *e)
+{
+    liberaFatorLU(e->LU);
+    free(e->A);
+    free(e);
+}
+
+
+// Guarda 'e', fora do cache e sem usuários, para reaproveitamento. Com a trava
+static void recicla (EntradaLU_t *e)
+{
+    if (nreciclagem == CACHE_LU_RECICLA){
+        // Descarta a mais antiga, no fim da lista
+        EntradaLU_t **p = &reciclagem;
+        while ((*p)->prox)
+            p = &(*p)->prox;
+        libera(*p);
+        *p = NULL;
+        nreciclagem--;
+    }
+    e->prox = reciclagem;
+    reciclagem = e;
+    nreciclagem++;
+}
+
+
+// Retira da reciclagem uma entrada de ordem n, ou NULL. Com a trava
+static EntradaLU_t *reaproveita (unsigned int n)
+{
+    for (EntradaLU_t **p = &reciclagem; *p; p = &(*p)->prox)
+        if ((*p)->LU->n == n){
+            EntradaLU_t *e = *p;
+            *p = e->prox;
+            nreciclagem--;
+            return e;
+        }
+    return NULL;
+}
+
+
+static EntradaLU_t *procura (uint64_t h, SistLinear_t *SL)
+{
+    for (EntradaLU_t *e = tabela[h % CACHE_LU_BALDES]; e; e = e->proxBalde)
+        if (e->hash == h && e->LU->n == SL->n && mesmaMatriz(e->A, SL))
+            return e;
+    return NULL;
+}
+
+
+// Move 'e', já na lista, para a posição de mais recente
+static void paraFrente (EntradaLU_t *e)
+{
+    if (e == recente)
+        return;
+
+    e->ant->prox = e->prox;
+    if (e->prox)
+        e->prox->ant = e->ant;
+    else
+        antiga = e->ant;
+
+    e->ant = NULL;
+    e->prox = recente;
+    recente->ant = e;
+    recente = e;
+}
+
+
+static void insere (EntradaLU_t *e)
+{
+    EntradaLU_t **balde = &tabela[e->hash % CACHE_LU_BALDES];
+    e->proxBalde = *balde;
+    *balde = e;
+
+    e->ant = NULL;
+    e->prox = recente;
+    if (recente)
+        recente->ant = e;
+    else
+        antiga = e;
+    recente = e;
+
+    ocupado += e->bytes;
+    e->removida = 0;
+}
+
+
+// Retira 'e' do cache. Liberada agora se ninguém a está usando
+static void retira (EntradaLU_t *e)
+{
+    EntradaLU_t **p = &tabela[e->hash % CACHE_LU_BALDES];
+    while (*p != e)
+        p = &(*p)->proxBalde;
+    *p = e->proxBalde;
+
+    if (e->ant)
+        e->ant->prox = e->prox;
+    else
+        recente = e->prox;
+    if (e->prox)
+        e->prox->ant = e->ant;
+    else
+        antiga = e->ant;
+
+    ocupado -= e->bytes;
+    e->removida = 1;
+    if (e->refs == 0)
+        recicla(e);
+}
+
+
+void defineCacheLU (size_t novo)
+{
+    pthread_mutex_lock(&trava);
+    limite = novo;
+    while (antiga)
+        retira(antiga);
+    while (reciclagem){
+        EntradaLU_t *e = reciclagem;
+        reciclagem = e->prox;
+        libera(e);
+    }
+    nreciclagem = 0;
+    pthread_mutex_unlock(&trava);
+}
+
+
+int cacheLUAtivo (void)
+{
+    // 'limite' só muda antes dos sistemas serem resolvidos
+    return limite > 0;
+}
+
+
+EntradaLU_t *obtemFatorLU (SistLinear_t *SL, int conta)
+{
+    unsigned int n = SL->n;
+    size_t m = (size_t) n * n;
+    uint64_t h = 0;
+    EntradaLU_t *e;
+
+    // 'limite' só muda antes dos sistemas serem resolvidos
+    int ativo = limite > 0;
+
+    if (ativo)
+        h = dispersao(SL);
+
+    pthread_mutex_lock(&trava);
+    if (ativo){
+        e = procura(h, SL);
+        if (e){
+            e->refs++;
+            paraFrente(e);
+            acertos += conta != 0;
+            pthread_mutex_unlock(&trava);
+            return e;
+        }
+        faltas += conta != 0;
+    }
+    e = reaproveita(n);
+    pthread_mutex_unlock(&trava);
+
+    if (!e){
+        e = calloc(1, sizeof(EntradaLU_t));
+        must_alloc(e, __func__);
+        e->LU = alocaFatorLU(n);
+    }
+    e->refs = 1;
+    e->removida = 1;
+
+    if (fatoraLU(SL, e->LU)){
+        devolveFatorLU(e);
+        return NULL;
+    }
+
+    e->bytes = sizeof(EntradaLU_t) + (m + (size_t) n * e->LU->lda) * sizeof(real_t) + n * sizeof(unsigned int);
+    if (!ativo || e->bytes > limite)
+        return e;
+
+    // Uma entrada reaproveitada pode já ter a cópia de A
+    if (!e->A){
+        e->A = malloc(m * sizeof(real_t));
+        must_alloc(e->A, __func__);
+    }
+    for (unsigned int i = 0; i < n; i++)
+        memcpy(e->A + (size_t) i * n, SL->A[i], n * sizeof(real_t));
+    e->hash = h;
+
+    pthread_mutex_lock(&trava);
+    EntradaLU_t *outra = procura(h, SL);
+    if (outra){
+        // Outra thread fatorou a mesma matriz enquanto esta calculava
+        outra->refs++;
+        paraFrente(outra);
+        e->refs = 0;
+        recicla(e);
+        pthread_mutex_unlock(&trava);
+        return outra;
+    }
+    while (ocupado + e->bytes > limite)
+        retira(antiga);
+    insere(e);
+    pthread_mutex_unlock(&trava);
+
+    return e;
+}
+
+
+void devolveFatorLU (EntradaLU_t *e)
+{
+    pthread_mutex_lock(&trava);
+    if (--e->refs == 0 && e->removida)
+        recicla(e);
+    pthread_mutex_unlock(&trava);
+}
+
+
+void estatisticasCacheLU (unsigned long *a, unsigned long *f)
+{
+    pthread_mutex_lock(&trava);
+    *a = acertos;
+    *f = faltas;
+    pthread_mutex_unlock(&trava);
+}
@@ -0,0 +1,42 @@
+#ifndef __CACHELU_H__
+#define __CACHELU_H__
+
+#include <stddef.h>
+#include <stdint.h>
+#include "SistemasLineares.h"
+
+#define CACHE_LU_LIMITE ((size_t) 64 << 20)  // Memória padrão do cache de fatorações (bytes)
+#define CACHE_LU_BALDES 1024  // Tamanho da tabela de dispersão
+#define CACHE_LU_RECICLA 4  // Entradas liberadas guardadas para reaproveitamento
+
+// Fatoração guardada no cache. Só 'LU' deve ser usado por quem a obteve
+typedef struct EntradaLU {
+  FatorLU_t *LU; // fatoração de A
+  real_t *A; // cópia compacta de A (n*n), para confirmar os acertos
+  uint64_t hash; // dispersão de A
+  size_t bytes; // memória ocupada pela entrada
+  int refs; // usuários da fatoração
+  int removida; // fora do cache: liberada pelo último usuário
+  struct EntradaLU *proxBalde; // próxima entrada do mesmo balde
+  struct EntradaLU *ant, *prox; // ordem de uso, da mais recente à mais antiga
+} EntradaLU_t;
+
+// Se o cache está ativo (limite maior que 0)
+int cacheLUAtivo(void);
+
+// Define o limite de memória do cache, em bytes (0 desativa).
+// Descarta as fatorações guardadas e libera as entradas a reaproveitar
+void defineCacheLU(size_t limite);
+
+// Fatoração LU de SL->A: do cache, se a mesma matriz já foi fatorada, ou
+// calculada e guardada, descartando as menos usadas recentemente. Com
+// 'conta' 0 a busca não entra nas estatísticas: o acerto esperado vem da
+// solução do mesmo sistema (refinamento), e não de reaproveitamento.
+// Retorna NULL se a fatoração falhou. Deve ser devolvida com devolveFatorLU
+EntradaLU_t *obtemFatorLU(SistLinear_t *SL, int conta);
+void devolveFatorLU(EntradaLU_t *E);
+
+// Acertos e faltas desde o início da execução, só das buscas com 'conta'
+void estatisticasCacheLU(unsigned long *acertos, unsigned long *faltas);
+
+#endif // __CACHELU_H__
@@ -0,0 +1,78 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "utils.h"
+#include "arquivos.h"
+#include "SistemasLineares.h"
+
+
+// Escreve um SL no formato texto, com dígitos suficientes para reproduzir cada real_t
+static void escreveSistLinearTexto (FILE *f, SistLinear_t *SL){
+    if (SL->nrhs > 1)
+        fprintf(f, "%u %u\n%.9g\n", SL->n, SL->nrhs, SL->erro);
+    else
+        fprintf(f, "%u\n%.9g\n", SL->n, SL->erro);
+    for (unsigned int i = 0; i < SL->n; i++){
+        for (unsigned int j = 0; j < SL->n; j++)
+            fprintf(f, "%.9g ", SL->A[i][j]);
+        fprintf(f, "\n");
+    }
+    if (SL->nrhs > 1)
+        for (unsigned int i = 0; i < SL->n; i++){
+            for (unsigned int c = 0; c < SL->nrhs; c++)
+                fprintf(f, "%.9g ", SL->b[(size_t) c * SL->n + i]);
+            fprintf(f, "\n");
+        }
+    else {
+        for (unsigned int i = 0; i < SL->n; i++)
+            fprintf(f, "%.9g ", SL->b[i]);
+        fprintf(f, "\n");
+    }
+}
+
+
+/*  Converte sistemas entre os formatos texto e binário (ver arquivos.h).
+    Opções:
+    -b  texto (stdin) para binário (stdout). Padrão
+    -t  binário (stdin) para texto (stdout)
+*/
+int main (int argc, char **argv){
+    int opt, binario = 1, counter = 0;
+    while ((opt = getopt(argc, argv, "bt")) != -1){
+        switch (opt){
+            case 'b':
+                binario = 1;
+                break;
+            case 't':
+                binario = 0;
+                break;
+            default:
+                fprintf(stderr, "Uso: %s [-b | -t] < entrada > saida\n", argv[0]);
+                return -1;
+        }
+    }
+
+    SistLinear_t *SL;
+    if (binario){
+        while ((SL = lerSistLinear()) != NULL){
+            if (escreveSistLinearBin(stdout, SL)){
+                perror("stdout");
+                return -1;
+            }
+            liberaSistLinear(SL);
+            counter++;
+        }
+    }
+    else
+        while ((SL = lerSistLinearBin(stdin)) != NULL){
+            if (counter > 0)
+                printf("\n");
+            escreveSistLinearTexto(stdout, SL);
+            liberaSistLinear(SL);
+            counter++;
+        }
+
+    fprintf(stderr, "%i sistemas convertidos.\n", counter);
+    return 0;
+}
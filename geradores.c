@@ -0,0 +1,171 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "utils.h"
+#include "geradores.h"
+#include "SistemasEsparsos.h"
+#include "SistemasBanda.h"
+
+static const char *nomes[FAMILIA_NUM] = { "densa", "dominante", "spd", "tridiagonal", "poisson" };
+
+
+// splitmix64: independente da libc, para que os sistemas sejam reproduzíveis
+static uint64_t proximo (uint64_t *estado)
+{
+    uint64_t z = (*estado += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+
+// Uniforme em [-1, 1]
+static real_t uniforme (uint64_t *estado)
+{
+    return (real_t) ((proximo(estado) >> 40) * (2.0 / (1 << 24)) - 1.0);
+}
+
+
+// Ordem do sistema gerado: Poisson usa o maior quadrado perfeito <= n
+static unsigned int ordem (Familia_t f, unsigned int n)
+{
+    if (f != FAMILIA_POISSON)
+        return n;
+    unsigned int m = (unsigned int) sqrt((double) n);
+    while ((m + 1) * (m + 1) <= n) m++;
+    return m * m;
+}
+
+
+// Famílias esparsas, montadas direto em CSR: tridiagonal e Poisson
+static SistLinearCSR_t *geraEsparso (Familia_t f, unsigned int n, uint64_t *estado)
+{
+    unsigned int i, k = 0;
+    unsigned int m = (unsigned int) sqrt((double) n);
+    unsigned int nnz = f == FAMILIA_TRIDIAGONAL ? 3 * n - 2 : 5 * n - 4 * m;
+
+    SistLinearCSR_t *SL = alocaSistLinearCSR(n, nnz);
+    SL->erro = 1e-5f;
+
+    for (i = 0; i < n; i++){
+        if (f == FAMILIA_TRIDIAGONAL){
+            real_t l = i > 0 ? uniforme(estado) : 0.0f;
+            real_t u = i + 1 < n ? uniforme(estado) : 0.0f;
+            if (i > 0){
+                SL->col[k] = i - 1;
+                SL->val[k++] = l;
+            }
+            SL->col[k] = i;
+            SL->val[k++] = fabsf(l) + fabsf(u) + 1.0f;
+            if (i + 1 < n){
+                SL->col[k] = i + 1;
+                SL->val[k++] = u;
+            }
+        }
+        else {
+            unsigned int lin = i / m, col = i % m;
+            if (lin > 0){ SL->col[k] = i - m; SL->val[k++] = -1.0f; }
+            if (col > 0){ SL->col[k] = i - 1; SL->val[k++] = -1.0f; }
+            SL->col[k] = i;
+            SL->val[k++] = 4.0f;
+            if (col + 1 < m){ SL->col[k] = i + 1; SL->val[k++] = -1.0f; }
+            if (lin + 1 < m){ SL->col[k] = i + m; SL->val[k++] = -1.0f; }
+        }
+        SL->lin[i + 1] = k;
+    }
+
+    for (i = 0; i < n; i++)
+        SL->b[i] = uniforme(estado);
+
+    return SL;
+}
+
+
+SistLinear_t *geraSistLinear (Familia_t f, unsigned int n, uint64_t semente)
+{
+    uint64_t estado = semente;
+    unsigned int i, j;
+
+    n = ordem(f, n);
+    SistLinear_t *SL = alocaSistLinear(n);
+    SL->erro = 1e-5f;
+    real_t **A = SL->A;
+
+    switch (f){
+        case FAMILIA_DENSA:
+            for (i = 0; i < n; i++)
+                for (j = 0; j < n; j++)
+                    A[i][j] = uniforme(&estado);
+            break;
+
+        case FAMILIA_DOMINANTE:
+        case FAMILIA_SPD:
+            for (i = 0; i < n; i++)
+                for (j = (f == FAMILIA_SPD ? i + 1 : 0); j < n; j++)
+                    if (j != i){
+                        A[i][j] = uniforme(&estado);
+                        if (f == FAMILIA_SPD)
+                            A[j][i] = A[i][j];
+                    }
+            // Soma dos módulos fora da diagonal, mais uma folga
+            for (i = 0; i < n; i++){
+                double soma = 0.0;
+                for (j = 0; j < n; j++)
+                    if (j != i)
+                        soma += fabsf(A[i][j]);
+                A[i][i] = soma + 1.0;
+            }
+            break;
+
+        case FAMILIA_TRIDIAGONAL:
+        case FAMILIA_POISSON: {
+            // O mesmo sistema de geraSistLinearCSR, expandido
+            SistLinearCSR_t *E = geraEsparso(f, n, &estado);
+            for (i = 0; i < n; i++)
+                for (unsigned int k = E->lin[i]; k < E->lin[i + 1]; k++)
+                    A[i][E->col[k]] = E->val[k];
+            memcpy(SL->b, E->b, sizeof(real_t) * n);
+            liberaSistLinearCSR(E);
+            detectaBanda(SL);
+            return SL;
+        }
+
+        default:
+            break;
+    }
+
+    for (i = 0; i < n; i++)
+        SL->b[i] = uniforme(&estado);
+
+    detectaBanda(SL);
+    return SL;
+}
+
+
+SistLinearCSR_t *geraSistLinearCSR (Familia_t f, unsigned int n, uint64_t semente)
+{
+    if (familiaEsparsa(f)){
+        uint64_t estado = semente;
+        return geraEsparso(f, ordem(f, n), &estado);
+    }
+
+    SistLinear_t *SL = geraSistLinear(f, n, semente);
+    SistLinearCSR_t *CSR = densoParaCSR(SL);
+    liberaSistLinear(SL);
+    return CSR;
+}
+
+
+int familiaEsparsa (Familia_t f)
+{
+    return f == FAMILIA_TRIDIAGONAL || f == FAMILIA_POISSON;
+}
+
+
+const char *nomeFamilia (Familia_t f)
+{
+    return f < FAMILIA_NUM ? nomes[f] : "?";
+}
+
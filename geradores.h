@@ -0,0 +1,33 @@
+#ifndef __GERADORES_H__
+#define __GERADORES_H__
+
+#include <stdint.h>
+#include "SistemasLineares.h"
+#include "SistemasEsparsos.h"
+
+// Famílias de sistemas sintéticos
+typedef enum {
+  FAMILIA_DENSA, // coeficientes uniformes em [-1, 1]: só eliminação
+  FAMILIA_DOMINANTE, // densa com diagonal estritamente dominante
+  FAMILIA_SPD, // simétrica, diagonal dominante e positiva (logo positiva definida)
+  FAMILIA_TRIDIAGONAL, // tridiagonal com diagonal dominante
+  FAMILIA_POISSON, // Laplaciano 2D de 5 pontos numa grade m x m (n = m*m)
+  FAMILIA_NUM
+} Familia_t;
+
+/*  Gera um sistema da família 'f' com ordem próxima de n (Poisson usa o
+    maior quadrado perfeito <= n). A mesma semente gera sempre o mesmo
+    sistema, em qualquer plataforma. b é uniforme em [-1, 1].
+*/
+SistLinear_t *geraSistLinear (Familia_t f, unsigned int n, uint64_t semente);
+
+// O mesmo sistema de geraSistLinear em CSR. As famílias esparsas são montadas
+// direto em CSR, sem a matriz densa; as densas são convertidas
+SistLinearCSR_t *geraSistLinearCSR (Familia_t f, unsigned int n, uint64_t semente);
+
+// Se a família é esparsa (tridiagonal e Poisson)
+int familiaEsparsa (Familia_t f);
+
+const char *nomeFamilia (Familia_t f);
+
+#endif // __GERADORES_H__
@@ -0,0 +1,155 @@
+#include "instrumenta.h"
+
+#ifdef INSTRUMENTACAO
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+/*  Cada thread abre, na primeira medição, um grupo de contadores (ciclos,
+    instruções e faltas de LLC) só dela, lido de uma vez com PERF_FORMAT_GROUP.
+    O início de cada fase fica em variáveis da thread; a diferença no fim é
+    somada aos totais globais com operações atômicas.
+*/
+
+#define CONTADORES 3
+
+static const char *nomes[FASE_NUM] = {
+    "pivoteamento", "trocas", "eliminação", "substituição", "varredura",
+    "convergência", "cópias", "precondicionador", "vetores"
+};
+
+static uint64_t tempo[FASE_NUM], chamadas[FASE_NUM], contador[FASE_NUM][CONTADORES];
+static int comContadores = 0; // alguma thread conseguiu abrir os contadores
+
+static __thread int grupo = 0; // 0: não aberto, -1: indisponível, > 0: descritor do líder
+static __thread int descritores[CONTADORES]; // do líder e dos demais eventos do grupo
+static __thread uint64_t inicioTempo[FASE_NUM], inicioContador[FASE_NUM][CONTADORES];
+
+
+static uint64_t agora (void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t) t.tv_sec * 1000000000ULL + t.tv_nsec;
+}
+
+
+static int abreContador (uint64_t config, int lider)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.read_format = PERF_FORMAT_GROUP;
+    attr.disabled = lider == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(SYS_perf_event_open, &attr, 0, -1, lider, 0);
+}
+
+
+static void abreGrupo (void)
+{
+    static const uint64_t eventos[CONTADORES] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES
+    };
+
+    grupo = -1;
+    int lider = abreContador(eventos[0], -1);
+    if (lider < 0)
+        return;
+    descritores[0] = lider;
+    for (int c = 1; c < CONTADORES; c++)
+        if ((descritores[c] = abreContador(eventos[c], lider)) < 0){
+            while (c-- > 0)
+                close(descritores[c]);
+            return;
+        }
+
+    ioctl(lider, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(lider, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    grupo = lider;
+    __atomic_store_n(&comContadores, 1, __ATOMIC_RELAXED);
+}
+
+
+// Lê os contadores da thread em v. Retorna 0 se leu
+static int leContadores (uint64_t *v)
+{
+    uint64_t buf[1 + CONTADORES]; // número de eventos, seguido dos valores
+
+    if (!grupo)
+        abreGrupo();
+    if (grupo < 0 || read(grupo, buf, sizeof(buf)) != sizeof(buf))
+        return -1;
+    memcpy(v, buf + 1, sizeof(uint64_t) * CONTADORES);
+    return 0;
+}
+
+
+void instrInicio (Fase_t f)
+{
+    if (leContadores(inicioContador[f]))
+        memset(inicioContador[f], 0, sizeof(inicioContador[f]));
+    inicioTempo[f] = agora();
+}
+
+
+void instrFim (Fase_t f)
+{
+    uint64_t t = agora(), v[CONTADORES];
+
+    __atomic_fetch_add(&tempo[f], t - inicioTempo[f], __ATOMIC_RELAXED);
+    __atomic_fetch_add(&chamadas[f], 1, __ATOMIC_RELAXED);
+    if (!leContadores(v))
+        for (int c = 0; c < CONTADORES; c++)
+            __atomic_fetch_add(&contador[f][c], v[c] - inicioContador[f][c], __ATOMIC_RELAXED);
+}
+
+
+void instrZera (void)
+{
+    for (int f = 0; f < FASE_NUM; f++){
+        __atomic_store_n(&tempo[f], 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&chamadas[f], 0, __ATOMIC_RELAXED);
+        for (int c = 0; c < CONTADORES; c++)
+            __atomic_store_n(&contador[f][c], 0, __ATOMIC_RELAXED);
+    }
+}
+
+
+// Fecha o grupo da thread. Uma nova medição na mesma thread o reabre
+void instrEncerraThread (void)
+{
+    if (grupo > 0)
+        for (int c = 0; c < CONTADORES; c++)
+            close(descritores[c]);
+    grupo = 0;
+}
+
+
+// Uma linha por fase executada desde o último instrZera, que é então feito
+void instrRelatorio (FILE *out)
+{
+    for (int f = 0; f < FASE_NUM; f++){
+        if (!chamadas[f])
+            continue;
+        fprintf(out, "--> Fase %s: %.6f ms, %lu chamadas", nomes[f], tempo[f] / 1e6, (unsigned long) chamadas[f]);
+        if (comContadores){
+            uint64_t *v = contador[f];
+            fprintf(out, ", %lu ciclos, %lu instruções (IPC %.2f), %lu faltas LLC",
+                    (unsigned long) v[0], (unsigned long) v[1], v[0] ? (double) v[1] / v[0] : 0.0,
+                    (unsigned long) v[2]);
+        }
+        fprintf(out, "\n");
+    }
+    instrZera();
+}
+
+#endif // INSTRUMENTACAO
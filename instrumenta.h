@@ -0,0 +1,54 @@
+#ifndef __INSTRUMENTA_H__
+#define __INSTRUMENTA_H__
+
+#include <stdio.h>
+
+/*  Instrumentação das fases dos métodos, ativada com -DINSTRUMENTACAO (ver
+    o alvo 'instrumentado' do Makefile). Sem ela, as macros não geram código.
+
+    Cada fase acumula tempo e número de chamadas e, se o kernel permitir
+    perf_event_open, ciclos, instruções e faltas na cache de último nível.
+    Os totais são globais, somados por todas as threads: com o pipeline (-p)
+    o relatório de um sistema inclui o que outros resolviam ao mesmo tempo.
+    As fases não se aninham.
+*/
+
+typedef enum {
+  FASE_PIVO, // busca do pivô
+  FASE_TROCA, // troca de linhas
+  FASE_ELIMINACAO, // atualização da matriz na fatoração
+  FASE_SUBSTITUICAO, // substituições com os fatores
+  FASE_VARREDURA, // varredura/produto pela matriz dos métodos iterativos
+  FASE_CONVERGENCIA, // critério de parada e verificação de valores inválidos
+  FASE_COPIA, // cópias entre vetores de iteração
+  FASE_PRECOND, // aplicação do precondicionador
+  FASE_VETORES, // operações entre vetores (atualizações, ortogonalização)
+  FASE_NUM
+} Fase_t;
+
+#ifdef INSTRUMENTACAO
+
+void instrInicio (Fase_t f);
+void instrFim (Fase_t f);
+void instrZera (void);
+void instrRelatorio (FILE *out);
+void instrEncerraThread (void);
+
+#define INSTR_INICIO(f) instrInicio(f)
+#define INSTR_FIM(f) instrFim(f)
+#define INSTR_ZERA() instrZera()
+#define INSTR_RELATORIO(out) instrRelatorio(out)
+// Fecha os contadores da thread; chamada antes de uma thread que mediu terminar
+#define INSTR_ENCERRA_THREAD() instrEncerraThread()
+
+#else
+
+#define INSTR_INICIO(f) ((void) 0)
+#define INSTR_FIM(f) ((void) 0)
+#define INSTR_ZERA() ((void) 0)
+#define INSTR_RELATORIO(out) ((void) 0)
+#define INSTR_ENCERRA_THREAD() ((void) 0)
+
+#endif // INSTRUMENTACAO
+
+#endif // __INSTRUMENTA_H__
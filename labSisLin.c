@@ -1,106 +1,598 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <unistd.h>
 
 #include "utils.h"
 #include "SistemasLineares.h"
+#include "SistemasEsparsos.h"
+#include "SistemasLote.h"
+#include "arquivos.h"
+#include "pipeline.h"
+#include "cacheLU.h"
+#include "analise.h"
+#include "reordena.h"
+#include "instrumenta.h"
 
+#define LOTE_MAX 4096  // Máximo de sistemas lidos antes de resolver um lote
 
-int main (){
+// Valor inicial dos métodos iterativos
+typedef enum { INICIO_ZERO, INICIO_ANTERIOR, INICIO_GAUSS } Inicio_t;
+
+// Configuração dos métodos, compartilhada pelas etapas do pipeline
+typedef struct {
+    real_t omega; // Gauss-Seidel multicolorido com relaxação omega (0: lexicográfico)
+    Precond_t precond; // precondicionador do gradiente conjugado
+    int automatico; // apenas o método escolhido por analisaSistLinear
+    int reordena; // reordena por RCM antes de resolver
+    Inicio_t inicio; // zero, solução do sistema anterior ou da eliminação de Gauss
+    real_t *anterior; // INICIO_ANTERIOR: solução guardada, na ordem original das variáveis
+    unsigned int nanterior; // ordem da solução guardada (0: nenhuma)
+} Metodos_t;
+
+
+// Valor inicial dos métodos iterativos de um sistema de ordem n (reordenado por
+// 'perm', ou NULL): a solução guardada do sistema anterior, se de mesma ordem, ou zero
+static void valorInicial (unsigned int n, const unsigned int *perm, real_t *x0, Metodos_t *cfg){
+    if (cfg->inicio != INICIO_ANTERIOR || cfg->nanterior != n){
+        memset(x0, 0, sizeof(real_t) * n);
+        return;
+    }
+    for (unsigned int i = 0; i < n; i++)
+        x0[i] = cfg->anterior[perm ? perm[i] : i];
+}
+
+
+// Com INICIO_ANTERIOR, guarda x se seu resíduo é o menor obtido até agora para
+// o sistema ('menor', que começa em INFINITY)
+static void guardaSolucao (unsigned int n, const unsigned int *perm, const real_t *x, double norma,
+                           double *menor, Metodos_t *cfg){
+    if (cfg->inicio != INICIO_ANTERIOR || !(norma < *menor))
+        return;
+    *menor = norma;
+
+    if (cfg->nanterior != n){
+        free(cfg->anterior);
+        cfg->anterior = malloc(sizeof(real_t) * n);
+        must_alloc(cfg->anterior, __func__);
+        cfg->nanterior = n;
+    }
+    for (unsigned int i = 0; i < n; i++)
+        cfg->anterior[perm ? perm[i] : i] = x[i];
+}
+
+
+// Resolve uma sequência de sistemas esparsos (formato CSR) por Jacobi e Gauss-Seidel,
+// ou GMRES se algum dos dois não tem convergência garantida
+static int resolveEsparsos (Metodos_t *cfg){
     int result, counter = 1;
-    double time;
-    SistLinear_t *SL = NULL;
-    real_t *x = NULL;
-    real_t *res = NULL;
-    double norma;
-    
-    while (!feof(stdin)){
-        SL = lerSistLinear();   
-        x = malloc(sizeof(real_t) * SL->n);
-
-        printf("***** Sistema %i --> n = %i, erro: %f\n", counter, SL->n, SL->erro);
-        fprintf(stderr, "***** Sistema %i --> n = %i, erro: %f\n", counter, SL->n, SL->erro);
-
-        result = eliminacaoGauss(SL, x, &time);
-        if (result == 0){
-            printf("===> Eliminação de Gauss: %1.10f ms\n--> X: ", time);
-            prnVetor(x, SL->n);
-            res = residue(SL, x);
-            norma = normaL2Residuo(SL, x, res);
-            free(res);
+    double time, norma, menor;
+    SistLinearCSR_t *SL;
+    real_t *x, *x0, *res;
 
-            printf("--> Norma L2 do residuo: %f\n\n", norma);
-            
-            if (norma > MAXNORMA){
-                result = refinamento(SL, x, &time);
-                res = residue(SL, x);
-                norma = normaL2Residuo(SL, x, res);
-                free(res);
-
-                if (result >= 0){
-                    printf("===> Refinamento: %1.10f ms --> %i iterações\n--> X: ", time, result);
-                    prnVetor(x, SL->n);
-                    printf("--> Norma L2 do residuo: %f\n\n", norma);
-                }
-            }
-        }
+    while ((SL = lerSistLinearCSR()) != NULL){
+        MarcaArena_t marca = arenaMarca();
+        x = arenaAloca(sizeof(real_t) * SL->n);
+        x0 = arenaAloca(sizeof(real_t) * SL->n);
+        res = arenaAloca(sizeof(real_t) * SL->n);
+        valorInicial(SL->n, NULL, x0, cfg);
+        menor = INFINITY;
+
+        printf("***** Sistema %i --> n = %i, nnz = %i, erro: %f\n", counter, SL->n, SL->nnz, SL->erro);
+        fprintf(stderr, "***** Sistema %i --> n = %i, nnz = %i, erro: %f\n", counter, SL->n, SL->nnz, SL->erro);
 
-        result = gaussJacobi(SL, x, &time);
+        INSTR_ZERA();
+        memcpy(x, x0, sizeof(real_t) * SL->n);
+        result = gaussJacobiCSR(SL, x, &time);
+        int diverge = result == -1;
         if (result >= 0){
             printf("===> Jacobi: %1.10f ms --> %i iterações\n--> X: ", time, result);
             prnVetor(x, SL->n);
+            residueCSR(SL, x, res);
+            norma = normaL2ResiduoCSR(SL, res);
+            guardaSolucao(SL->n, NULL, x, norma, &menor, cfg);
+            INSTR_RELATORIO(stdout);
+            printf("--> Norma L2 do residuo: %f\n\n", norma);
+        }
 
-            res = residue(SL, x);
-            norma = normaL2Residuo(SL, x, res);
-            free(res);
+        INSTR_ZERA();
+        memcpy(x, x0, sizeof(real_t) * SL->n);
+        result = gaussSeidelCSR(SL, x, &time);
+        diverge |= result == -1;
+        if (result >= 0){
+            printf("===> Gauss-Seidel: %1.10f ms --> %i iterações\n--> X: ", time, result);
+            prnVetor(x, SL->n);
+            residueCSR(SL, x, res);
+            norma = normaL2ResiduoCSR(SL, res);
+            guardaSolucao(SL->n, NULL, x, norma, &menor, cfg);
+            INSTR_RELATORIO(stdout);
+            printf("--> Norma L2 do residuo: %f\n\n", norma);
+        }
 
+        INSTR_ZERA();
+        memcpy(x, x0, sizeof(real_t) * SL->n);
+        if (diverge && (result = gmresCSR(SL, x, &time)) >= 0){
+            printf("===> GMRES: %1.10f ms --> %i iterações\n--> X: ", time, result);
+            prnVetor(x, SL->n);
+            residueCSR(SL, x, res);
+            norma = normaL2ResiduoCSR(SL, res);
+            guardaSolucao(SL->n, NULL, x, norma, &menor, cfg);
+            INSTR_RELATORIO(stdout);
             printf("--> Norma L2 do residuo: %f\n\n", norma);
+        }
+
+        arenaRetorna(marca);
+        liberaSistLinearCSR(SL);
+        counter++;
+    }
 
-            if (norma > MAXNORMA){
-                result = refinamento(SL, x, &time);
-                res = residue(SL, x);
-                norma = normaL2Residuo(SL, x, res);
-                free(res);
-
-                if (result >= 0){
-                    printf("===> Refinamento: %1.10f ms --> %i iterações\n--> X: ", time, result);
-                    prnVetor(x, SL->n);
-                    printf("--> Norma L2 do residuo: %f\n\n", norma);
-                }
+    return 0;
+}
+
+
+// Resolve todas as colunas de b de SL com uma única fatoração e escreve os resultados em 'out'
+static void processaMultiplo (SistLinear_t *SL, int counter, FILE *out){
+    double time;
+
+    MarcaArena_t marca = arenaMarca();
+    real_t *X = arenaAloca(sizeof(real_t) * SL->n * SL->nrhs);
+    real_t *res = arenaAloca(sizeof(real_t) * SL->n);
+
+    fprintf(out, "***** Sistema %i --> n = %i, k = %i, erro: %f\n", counter, SL->n, SL->nrhs, SL->erro);
+    fprintf(stderr, "***** Sistema %i --> n = %i, k = %i, erro: %f\n", counter, SL->n, SL->nrhs, SL->erro);
+
+    INSTR_ZERA();
+    if (eliminacaoGaussMultiplo(SL, X, &time) == 0){
+        fprintf(out, "===> Eliminação de Gauss: %1.10f ms\n", time);
+        for (unsigned int c = 0; c < SL->nrhs; c++){
+            real_t *x = X + (size_t) c * SL->n;
+            fprintf(out, "--> X[%u]: ", c);
+            fprnSolucao(out, SL, x);
+            residue_col(SL, x, c, res);
+            fprintf(out, "--> Norma L2 do residuo: %f\n", normaL2Residuo(SL, x, res));
+        }
+        INSTR_RELATORIO(out); // da solução de todas as colunas
+        fprintf(out, "\n");
+    }
+
+    arenaRetorna(marca);
+}
+
+
+// Resolve e imprime um lote formado pelos sistemas SL[0..nsis-1], de mesmo tamanho
+static void processaLote (SistLinear_t **SL, unsigned int nsis, int primeiro, double *tTotal){
+    unsigned int n = SL[0]->n;
+    LoteSL_t *L = alocaLote(n, nsis);
+    for (unsigned int s = 0; s < nsis; s++)
+        loteInsere(L, s, SL[s]);
+
+    MarcaArena_t marca = arenaMarca();
+    real_t *X = arenaAloca(sizeof(real_t) * L->nblocos * n * LOTE_LARGURA);
+    real_t *x = arenaAloca(sizeof(real_t) * n);
+    real_t *res = arenaAloca(sizeof(real_t) * n);
+    int *status = arenaAloca(sizeof(int) * nsis);
+
+    double time;
+    INSTR_ZERA();
+    resolveLote(L, X, status, &time);
+    *tTotal += time;
+
+    for (unsigned int s = 0; s < nsis; s++){
+        printf("***** Sistema %i --> n = %i, erro: %f\n", primeiro + s, n, SL[s]->erro);
+        if (status[s] == 0){
+            loteSolucao(L, s, X, x);
+            printf("--> X: ");
+            prnVetor(x, n);
+            residue(SL[s], x, res);
+            printf("--> Norma L2 do residuo: %f\n\n", normaL2Residuo(SL[s], x, res));
+        }
+        else
+            fprintf(stderr, "Sistema %i: Gauss-Jordan floating point error.\n", primeiro + s);
+        liberaSistLinear(SL[s]);
+    }
+    INSTR_RELATORIO(stdout); // do lote inteiro
+
+    liberaLote(L);
+    arenaRetorna(marca);
+}
+
+
+// Lê sistemas e os resolve em lotes de sistemas consecutivos de mesmo tamanho
+static int resolveLotes (){
+    SistLinear_t **SL = malloc(sizeof(SistLinear_t*) * LOTE_MAX);
+    must_alloc(SL, __func__);
+
+    unsigned int nsis = 0;
+    int counter = 1;
+    double time = 0.0;
+
+    SistLinear_t *novo;
+    while ((novo = lerSistLinear()) != NULL){
+        if (novo->nrhs > 1){
+            // Várias colunas de b: já amortiza a fatoração, resolvido fora do lote
+            if (nsis > 0){
+                processaLote(SL, nsis, counter, &time);
+                counter += nsis;
+                nsis = 0;
             }
+            processaMultiplo(novo, counter++, stdout);
+            liberaSistLinear(novo);
+            continue;
         }
+        if (nsis == LOTE_MAX || (nsis > 0 && novo->n != SL[0]->n)){
+            processaLote(SL, nsis, counter, &time);
+            counter += nsis;
+            nsis = 0;
+        }
+        SL[nsis++] = novo;
+    }
+    if (nsis > 0){
+        processaLote(SL, nsis, counter, &time);
+        counter += nsis;
+    }
 
-        result = gaussSeidel(SL, x, &time);
-        if (result >= 0){
-            printf("===> Gauss-Seidel: %1.10f ms --> %i iterações\n--> X: ", time, result);
-            prnVetor(x, SL->n);
+    fprintf(stderr, "===> Lote: %i sistemas em %1.10f ms --> %.0f sistemas/s\n",
+            counter - 1, time, (counter - 1) / (time / 1000.0));
+
+    free(SL);
+    return 0;
+}
+
+
+// Reordena SL por RCM e relata banda e perfil antes e depois. Retorna o
+// sistema reordenado, ou NULL se a reordenação não reduz nem banda nem perfil
+static SistLinear_t *reordenaRCM (SistLinear_t *SL, int counter){
+    double time = timestamp();
+    SistLinear_t *R = permutaSistLinear(SL, ordemRCM(SL));
+    time = timestamp() - time;
+
+    unsigned long antes = perfilSistLinear(SL), depois = perfilSistLinear(R);
+    fprintf(stderr, "Sistema %i: RCM %1.10f ms --> banda %u/%u -> %u/%u, perfil %lu -> %lu\n",
+            counter, time, SL->kl, SL->ku, R->kl, R->ku, antes, depois);
+
+    if (R->kl + R->ku >= SL->kl + SL->ku && depois >= antes){
+        liberaSistLinear(R);
+        return NULL;
+    }
+    return R;
+}
 
-            res = residue(SL, x);
+
+// Executa o método 'm' em SL. Retorna o resultado do método
+static int executaMetodo (Metodo_t m, SistLinear_t *SL, real_t *x, Metodos_t *cfg, double *time){
+    switch (m){
+        case METODO_GAUSS:
+            return eliminacaoGauss(SL, x, time);
+        case METODO_JACOBI:
+            return gaussJacobi(SL, x, time);
+        case METODO_SEIDEL:
+            return cfg->omega > 0.0f ? gaussSeidelMulticor(SL, x, cfg->omega, time) : gaussSeidel(SL, x, time);
+        case METODO_GC:
+            return gradienteConjugadoPrecond(SL, x, cfg->precond, time);
+        case METODO_GMRES:
+            return gmres(SL, x, time);
+        default:
+            return -1;
+    }
+}
+
+
+// Resolve SL só pelo método escolhido pela análise; a reserva é usada se ele
+// falhar ou deixar resíduo acima de MAXNORMA
+static void processaAuto (SistLinear_t *SL, int counter, FILE *out, Metodos_t *cfg){
+    AnaliseSL_t R;
+    double time, norma = 0.0;
+    int result;
+
+    MarcaArena_t marca = arenaMarca();
+    real_t *x = arenaAloca(sizeof(real_t) * SL->n);
+    real_t *x0 = arenaAloca(sizeof(real_t) * SL->n); // valor inicial; INICIO_GAUSS não se aplica
+    real_t *res = arenaAloca(sizeof(real_t) * SL->n);
+    valorInicial(SL->n, SL->perm, x0, cfg);
+
+    fprintf(out, "***** Sistema %i --> n = %i, erro: %f\n", counter, SL->n, SL->erro);
+    fprintf(stderr, "***** Sistema %i --> n = %i, erro: %f\n", counter, SL->n, SL->erro);
+
+    time = timestamp();
+    analisaSistLinear(SL, &R);
+    time = timestamp() - time;
+    fprintf(out, "===> Análise: %1.10f ms --> %s (%s)\n", time, nomeMetodo(R.metodo), R.motivo);
+
+    Metodo_t m = R.metodo;
+    INSTR_ZERA();
+    memcpy(x, x0, sizeof(real_t) * SL->n);
+    result = executaMetodo(m, SL, x, cfg, &time);
+    if (result >= 0){
+        residue(SL, x, res);
+        norma = normaL2Residuo(SL, x, res);
+    }
+
+    if ((result < 0 || norma > MAXNORMA) && R.reserva != METODO_NENHUM){
+        fprintf(out, "===> %s falhou, usando %s\n", nomeMetodo(m), nomeMetodo(R.reserva));
+        m = R.reserva;
+        INSTR_ZERA();
+        memcpy(x, x0, sizeof(real_t) * SL->n);
+        result = executaMetodo(m, SL, x, cfg, &time);
+        if (result >= 0){
+            residue(SL, x, res);
             norma = normaL2Residuo(SL, x, res);
-            free(res);
+        }
+    }
+
+    if (result >= 0){
+        if (m == METODO_GAUSS)
+            fprintf(out, "===> %s: %1.10f ms\n--> X: ", nomeMetodo(m), time);
+        else
+            fprintf(out, "===> %s: %1.10f ms --> %i iterações\n--> X: ", nomeMetodo(m), time, result);
+        fprnSolucao(out, SL, x);
+        double menor = INFINITY;
+        guardaSolucao(SL->n, SL->perm, x, norma, &menor, cfg);
+        INSTR_RELATORIO(out);
+        fprintf(out, "--> Norma L2 do residuo: %f\n\n", norma);
+    }
+    else
+        fprintf(out, "===> Sem solução\n\n");
+
+    arenaRetorna(marca);
+}
 
-            printf("--> Norma L2 do residuo: %f\n\n", norma);
 
-            if (norma > MAXNORMA){
-                result = refinamento(SL, x, &time);
-                res = residue(SL, x);
-                norma = normaL2Residuo(SL, x, res);
-                free(res);
-
-                if (result >= 0){
-                    printf("===> Refinamento: %1.10f ms --> %i iterações\n--> X: ", time, result);
-                    prnVetor(x, SL->n);
-                    printf("--> Norma L2 do residuo: %f\n\n", norma);
-                }
+// Escreve em 'out' a solução x obtida pelo método 'metodo' (com o tempo e, se
+// iter >= 0, as iterações) e a norma de seu resíduo, e a guarda para -i a. Se
+// 'refina' e o resíduo passa de MAXNORMA, relata também o refinamento de x.
+// Com x0 não nulo, copia para x0 a solução final (INICIO_GAUSS)
+static void relataSolucao (SistLinear_t *SL, const char *metodo, double time, int iter,
+                           real_t *x, real_t *res, real_t *x0, int refina,
+                           double *menor, FILE *out, Metodos_t *cfg){
+    if (iter >= 0)
+        fprintf(out, "===> %s: %1.10f ms --> %i iterações\n--> X: ", metodo, time, iter);
+    else
+        fprintf(out, "===> %s: %1.10f ms\n--> X: ", metodo, time);
+    fprnSolucao(out, SL, x);
+
+    residue(SL, x, res);
+    double norma = normaL2Residuo(SL, x, res);
+    if (x0)
+        memcpy(x0, x, sizeof(real_t) * SL->n);
+
+    guardaSolucao(SL->n, SL->perm, x, norma, menor, cfg);
+    INSTR_RELATORIO(out);
+    fprintf(out, "--> Norma L2 do residuo: %f\n\n", norma);
+
+    if (refina && norma > MAXNORMA){
+        INSTR_ZERA();
+        int result = refinamento(SL, x, &time);
+        if (result >= 0)
+            relataSolucao(SL, "Refinamento", time, result, x, res, x0, 0, menor, out, cfg);
+    }
+}
+
+
+// Resolve o sistema SL por todos os métodos e escreve os resultados em 'out'.
+// Sistemas com várias colunas de b são resolvidos apenas por eliminação de Gauss
+static void processaSistema (SistLinear_t *SL, int counter, FILE *out, Metodos_t *cfg){
+    int result;
+    double time;
+
+    if (cfg->reordena){
+        SistLinear_t *R = reordenaRCM(SL, counter);
+        if (R){
+            Metodos_t semReordenar = *cfg;
+            semReordenar.reordena = 0;
+            processaSistema(R, counter, out, &semReordenar);
+            if (cfg->inicio == INICIO_ANTERIOR){ // nunca com pipeline: cfg não é compartilhada
+                cfg->anterior = semReordenar.anterior;
+                cfg->nanterior = semReordenar.nanterior;
             }
+            liberaSistLinear(R);
+            return;
         }
+    }
 
-        liberaSistLinear(SL);
-        free(x);
+    if (SL->nrhs > 1){
+        processaMultiplo(SL, counter, out);
+        return;
+    }
+    if (cfg->automatico){
+        processaAuto(SL, counter, out, cfg);
+        return;
+    }
 
-        counter++;
-        getchar(); // Consome o \n
+    MarcaArena_t marca = arenaMarca();
+    real_t *x = arenaAloca(sizeof(real_t) * SL->n);
+    real_t *x0 = arenaAloca(sizeof(real_t) * SL->n); // valor inicial dos métodos iterativos
+    real_t *res = arenaAloca(sizeof(real_t) * SL->n);
+    double menor = INFINITY; // menor resíduo obtido, para guardaSolucao
+
+    // Antes da eliminação de Gauss, que pode substituir a solução guardada
+    valorInicial(SL->n, SL->perm, x0, cfg);
+
+    fprintf(out, "***** Sistema %i --> n = %i, erro: %f\n", counter, SL->n, SL->erro);
+    fprintf(stderr, "***** Sistema %i --> n = %i, erro: %f\n", counter, SL->n, SL->erro);
+
+    INSTR_ZERA();
+    result = eliminacaoGauss(SL, x, &time);
+    if (result == 0)
+        relataSolucao(SL, "Eliminação de Gauss", time, -1, x, res,
+                      cfg->inicio == INICIO_GAUSS ? x0 : NULL, 1, &menor, out, cfg);
+
+    INSTR_ZERA();
+    memcpy(x, x0, sizeof(real_t) * SL->n);
+    result = gaussJacobi(SL, x, &time);
+    int diverge = result == -1; // critério de convergência de Jacobi ou Gauss-Seidel falhou
+    if (result >= 0)
+        relataSolucao(SL, "Jacobi", time, result, x, res, NULL, 1, &menor, out, cfg);
+
+    INSTR_ZERA();
+    memcpy(x, x0, sizeof(real_t) * SL->n);
+    if (cfg->omega > 0.0f)
+        result = gaussSeidelMulticor(SL, x, cfg->omega, &time);
+    else
+        result = gaussSeidel(SL, x, &time);
+    diverge |= result == -1;
+    if (result >= 0)
+        relataSolucao(SL, "Gauss-Seidel", time, result, x, res, NULL, 1, &menor, out, cfg);
+
+    if (diverge){
+        INSTR_ZERA();
+        memcpy(x, x0, sizeof(real_t) * SL->n);
+        result = gmres(SL, x, &time);
+        if (result >= 0)
+            relataSolucao(SL, "GMRES", time, result, x, res, NULL, 0, &menor, out, cfg);
     }
-    
-    return 0;
+
+    // Gradiente conjugado só se aplica a matrizes simétricas
+    if (simetrica(SL)){
+        INSTR_ZERA();
+        memcpy(x, x0, sizeof(real_t) * SL->n);
+        result = gradienteConjugadoPrecond(SL, x, cfg->precond, &time);
+        if (result >= 0)
+            relataSolucao(SL, "Gradiente Conjugado", time, result, x, res, NULL, 1, &menor, out, cfg);
+    }
+
+    arenaRetorna(marca);
+}
+
+
+// Adaptadores das etapas do pipeline
+static SistLinear_t *leEntrada (void *arg){
+    return lerSistLinear();
+}
+
+static SistLinear_t *leMapeado (void *arg){
+    return proximoMapeado((MapaSL_t*) arg);
+}
+
+static void resolveEtapa (SistLinear_t *SL, int counter, FILE *out, void *arg){
+    processaSistema(SL, counter, out, (Metodos_t*) arg);
+}
+
+
+// Relata o uso do cache de fatorações e libera as fatorações guardadas, a
+// área de trabalho da thread principal e a solução guardada por -i a
+static int encerra (int result, Metodos_t *cfg){
+    unsigned long acertos, faltas;
+    estatisticasCacheLU(&acertos, &faltas);
+    if (acertos + faltas > 0)
+        fprintf(stderr, "===> Cache LU: %lu acertos, %lu faltas\n", acertos, faltas);
+    defineCacheLU(0);
+    arenaDescarta();
+    INSTR_ENCERRA_THREAD();
+    free(cfg->anterior);
+    return result;
+}
+
+
+/*  Opções:
+    -t N  número de threads dos métodos paralelos (0 usa o padrão do OpenMP)
+    -c W  Gauss-Seidel multicolorido com relaxação W (1 = sem relaxação; W > 1 sem garantia de convergência)
+    -s    entrada com sistemas esparsos (ver lerSistLinearCSR)
+    -l    resolve sistemas consecutivos de mesmo tamanho em lote, por eliminação de Gauss
+    -m A  lê os sistemas do arquivo binário A mapeado em memória (ver conversor)
+    -p N  leitura, solução (N threads) e escrita em pipeline, mantendo a ordem da saída
+    -k M  limite de M MiB para o cache de fatorações LU (0 desativa)
+    -g P  precondicionador do gradiente conjugado: n (nenhum), j (Jacobi, padrão) ou c (Cholesky incompleto)
+    -i I  valor inicial dos métodos iterativos: z (zero, padrão), a (solução de menor resíduo do
+          sistema anterior, se de mesma ordem; não com -p) ou g (resultado da eliminação de Gauss,
+          refinado se houve refinamento; não com -s ou -a). Sem efeito com -l
+    -a    resolve cada sistema só pelo método escolhido pela análise da matriz
+    -r    reordena cada sistema por Reverse Cuthill-McKee, se isso reduzir banda ou perfil
+*/
+int main (int argc, char **argv){
+    int opt;
+    Metodos_t cfg = { 0.0f, PRECOND_JACOBI, 0, 0, INICIO_ZERO, NULL, 0 };
+    int esparso = 0, lote = 0;
+    int solvers = 0; // 0: sem pipeline
+    char *mapa = NULL;
+    while ((opt = getopt(argc, argv, "t:c:slm:p:k:g:i:ar")) != -1){
+        switch (opt){
+            case 't':
+                defineThreads(atoi(optarg));
+                break;
+            case 'c':
+                cfg.omega = atof(optarg);
+                break;
+            case 's':
+                esparso = 1;
+                break;
+            case 'l':
+                lote = 1;
+                break;
+            case 'm':
+                mapa = optarg;
+                break;
+            case 'p':
+                solvers = atoi(optarg);
+                break;
+            case 'k':
+                defineCacheLU((size_t) atoi(optarg) << 20);
+                break;
+            case 'a':
+                cfg.automatico = 1;
+                break;
+            case 'r':
+                cfg.reordena = 1;
+                break;
+            case 'g':
+                cfg.precond = optarg[0] == 'n' ? PRECOND_NENHUM : optarg[0] == 'c' ? PRECOND_CHOLESKY : PRECOND_JACOBI;
+                break;
+            case 'i':
+                cfg.inicio = optarg[0] == 'a' ? INICIO_ANTERIOR : optarg[0] == 'g' ? INICIO_GAUSS : INICIO_ZERO;
+                break;
+            default:
+                fprintf(stderr, "Uso: %s [-t threads] [-c omega] [-s] [-l] [-m arquivo] [-p solvers] [-k MiB] [-g n|j|c] [-i z|a|g] [-a] [-r] < entrada\n", argv[0]);
+                return -1;
+        }
+    }
+
+    // Sistemas resolvidos em paralelo não têm um anterior definido
+    if (solvers > 0 && cfg.inicio == INICIO_ANTERIOR){
+        fprintf(stderr, "-i a ignorado com -p: valor inicial zero\n");
+        cfg.inicio = INICIO_ZERO;
+    }
+    // Sem eliminação de Gauss antes dos métodos iterativos (-s), ou sem métodos iterativos (-l)
+    if ((esparso && cfg.inicio == INICIO_GAUSS) || (lote && !esparso && cfg.inicio != INICIO_ZERO)){
+        fprintf(stderr, "-i %c ignorado com %s: valor inicial zero\n", cfg.inicio == INICIO_GAUSS ? 'g' : 'a', esparso ? "-s" : "-l");
+        cfg.inicio = INICIO_ZERO;
+    }
+    // A análise escolhe um único método, sem eliminação de Gauss antes dele
+    if (cfg.automatico && cfg.inicio == INICIO_GAUSS){
+        fprintf(stderr, "-i g ignorado com -a: valor inicial zero\n");
+        cfg.inicio = INICIO_ZERO;
+    }
+
+    if (esparso)
+        return encerra(resolveEsparsos(&cfg), &cfg);
+    if (lote)
+        return encerra(resolveLotes(), &cfg);
+
+    int counter = 1;
+    SistLinear_t *SL;
+
+    if (mapa){
+        MapaSL_t *M = mapeiaSistemas(mapa);
+        if (!M)
+            return -1;
+        if (solvers > 0)
+            executaPipeline(leMapeado, M, liberaVisaoSL, resolveEtapa, &cfg, solvers);
+        else while ((SL = proximoMapeado(M)) != NULL){
+            processaSistema(SL, counter++, stdout, &cfg);
+            liberaVisaoSL(SL);
+        }
+        desmapeiaSistemas(M);
+        return encerra(0, &cfg);
+    }
+
+    if (solvers > 0){
+        executaPipeline(leEntrada, NULL, liberaSistLinear, resolveEtapa, &cfg, solvers);
+        return encerra(0, &cfg);
+    }
+
+    while ((SL = lerSistLinear()) != NULL){
+        processaSistema(SL, counter++, stdout, &cfg);
+        liberaSistLinear(SL);
+    }
+
+    return encerra(0, &cfg);
 }
\ No newline at end of file
@@ -0,0 +1,174 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "utils.h"
+#include "arena.h"
+#include "pipeline.h"
+#include "instrumenta.h"
+
+/*  Todas as etapas compartilham uma janela circular de PIPELINE_JANELA
+    posições, indexada pelo número de sequência do sistema. O leitor só lê o
+    sistema 'seq' quando seq - escritos < PIPELINE_JANELA, o que limita a
+    memória e garante que a posição seq % PIPELINE_JANELA está livre.
+*/
+
+typedef struct {
+    SistLinear_t *SL; // sistema lido, aguardando um solver
+    char *saida; // resultado formatado, aguardando o escritor
+    size_t tam;
+    int pronto; // 'saida' preenchida
+} Posicao_t;
+
+typedef struct {
+    leSL_t le;
+    void *argLe;
+    liberaSL_t libera;
+    resolveSL_t resolve;
+    void *argResolve;
+
+    Posicao_t janela[PIPELINE_JANELA];
+    int lidos; // sistemas lidos (próximo seq a ler)
+    int retirados; // próximo seq a ser entregue a um solver
+    int escritos; // próximo seq a ser escrito
+    int fim; // leitor chegou ao fim da entrada
+
+    pthread_mutex_t trava;
+    pthread_cond_t temEspaco; // leitor: janela liberou posição
+    pthread_cond_t temSistema; // solvers: há sistema lido ou fim
+    pthread_cond_t temSaida; // escritor: resultado pronto ou fim
+} Pipeline_t;
+
+
+static void *leitor (void *arg)
+{
+    Pipeline_t *P = arg;
+    SistLinear_t *SL;
+
+    for (;;){
+        pthread_mutex_lock(&P->trava);
+        while (P->lidos - P->escritos >= PIPELINE_JANELA)
+            pthread_cond_wait(&P->temEspaco, &P->trava);
+        pthread_mutex_unlock(&P->trava);
+
+        SL = P->le(P->argLe);
+
+        pthread_mutex_lock(&P->trava);
+        if (!SL){
+            P->fim = 1;
+            pthread_cond_broadcast(&P->temSistema);
+            pthread_cond_signal(&P->temSaida);
+            pthread_mutex_unlock(&P->trava);
+            return NULL;
+        }
+        P->janela[P->lidos % PIPELINE_JANELA].SL = SL;
+        P->lidos++;
+        pthread_cond_signal(&P->temSistema);
+        pthread_mutex_unlock(&P->trava);
+    }
+}
+
+
+static void *solver (void *arg)
+{
+    Pipeline_t *P = arg;
+
+    for (;;){
+        pthread_mutex_lock(&P->trava);
+        while (P->retirados == P->lidos && !P->fim)
+            pthread_cond_wait(&P->temSistema, &P->trava);
+        if (P->retirados == P->lidos){ // fim e nada mais a resolver
+            pthread_mutex_unlock(&P->trava);
+            arenaDescarta();
+            INSTR_ENCERRA_THREAD();
+            return NULL;
+        }
+        int seq = P->retirados++;
+        Posicao_t *pos = &P->janela[seq % PIPELINE_JANELA];
+        SistLinear_t *SL = pos->SL;
+        pthread_mutex_unlock(&P->trava);
+
+        char *saida = NULL;
+        size_t tam = 0;
+        FILE *out = open_memstream(&saida, &tam);
+        must_alloc(out, __func__);
+        P->resolve(SL, seq + 1, out, P->argResolve);
+        fclose(out);
+        P->libera(SL);
+
+        pthread_mutex_lock(&P->trava);
+        pos->saida = saida;
+        pos->tam = tam;
+        pos->pronto = 1;
+        if (seq == P->escritos)
+            pthread_cond_signal(&P->temSaida);
+        pthread_mutex_unlock(&P->trava);
+    }
+}
+
+
+int executaPipeline (leSL_t le, void *argLe, liberaSL_t libera,
+                     resolveSL_t resolve, void *argResolve, int nsolvers)
+{
+    Pipeline_t *P = calloc(1, sizeof(Pipeline_t));
+    must_alloc(P, __func__);
+
+    P->le = le;
+    P->argLe = argLe;
+    P->libera = libera;
+    P->resolve = resolve;
+    P->argResolve = argResolve;
+    pthread_mutex_init(&P->trava, NULL);
+    pthread_cond_init(&P->temEspaco, NULL);
+    pthread_cond_init(&P->temSistema, NULL);
+    pthread_cond_init(&P->temSaida, NULL);
+
+    if (nsolvers < 1)
+        nsolvers = 1;
+    pthread_t tLeitor, *tSolvers = malloc(nsolvers * sizeof(pthread_t));
+    must_alloc(tSolvers, __func__);
+
+    pthread_create(&tLeitor, NULL, leitor, P);
+    for (int i = 0; i < nsolvers; i++)
+        pthread_create(&tSolvers[i], NULL, solver, P);
+
+    // Escritor: entrega os resultados na ordem de entrada
+    for (;;){
+        pthread_mutex_lock(&P->trava);
+        Posicao_t *pos = &P->janela[P->escritos % PIPELINE_JANELA];
+        while (!pos->pronto && !(P->fim && P->escritos == P->lidos))
+            pthread_cond_wait(&P->temSaida, &P->trava);
+        if (!pos->pronto){
+            pthread_mutex_unlock(&P->trava);
+            break;
+        }
+        char *saida = pos->saida;
+        size_t tam = pos->tam;
+        pthread_mutex_unlock(&P->trava);
+
+        fwrite(saida, 1, tam, stdout);
+        free(saida);
+
+        pthread_mutex_lock(&P->trava);
+        pos->pronto = 0;
+        P->escritos++;
+        pthread_cond_signal(&P->temEspaco);
+        // O próximo resultado pode já estar pronto; o laço verifica sem esperar
+        pthread_mutex_unlock(&P->trava);
+    }
+
+    pthread_join(tLeitor, NULL);
+    for (int i = 0; i < nsolvers; i++)
+        pthread_join(tSolvers[i], NULL);
+
+    int total = P->escritos;
+
+    pthread_mutex_destroy(&P->trava);
+    pthread_cond_destroy(&P->temEspaco);
+    pthread_cond_destroy(&P->temSistema);
+    pthread_cond_destroy(&P->temSaida);
+    free(tSolvers);
+    free(P);
+
+    return total;
+}
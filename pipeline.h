@@ -0,0 +1,24 @@
+#ifndef __PIPELINE_H__
+#define __PIPELINE_H__
+
+#include <stdio.h>
+#include "SistemasLineares.h"
+
+#define PIPELINE_JANELA 64  // Máximo de sistemas lidos e ainda não escritos
+
+// Etapas fornecidas pelo usuário do pipeline
+typedef SistLinear_t *(*leSL_t)(void *arg); // retorna NULL no fim da entrada
+typedef void (*liberaSL_t)(SistLinear_t *SL);
+typedef void (*resolveSL_t)(SistLinear_t *SL, int counter, FILE *out, void *arg);
+
+/*  Executa leitura, solução e escrita em paralelo: uma thread lê os sistemas,
+    'nsolvers' threads os resolvem e a thread chamadora escreve os resultados
+    na saída padrão, na ordem de entrada. 'counter' começa em 1. No máximo
+    PIPELINE_JANELA sistemas ficam em memória ao mesmo tempo.
+
+    Retorna o número de sistemas processados.
+*/
+int executaPipeline (leSL_t le, void *argLe, liberaSL_t libera,
+                     resolveSL_t resolve, void *argResolve, int nsolvers);
+
+#endif // __PIPELINE_H__
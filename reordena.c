@@ -0,0 +1,191 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils.h"
+#include "arena.h"
+#include "reordena.h"
+#include "SistemasBanda.h"
+
+/*  O grafo tem um vértice por linha e uma aresta i-j se a_ij ou a_ji não é
+    nulo. Cada componente é percorrida em largura a partir de um vértice
+    pseudo-periférico, visitando os vizinhos em ordem crescente de grau; a
+    ordem final é invertida, o que reduz o perfil sem alterar a banda.
+*/
+
+typedef struct {
+    unsigned int *adj; // vizinhos, em ordem crescente de grau
+    unsigned int *ini; // vizinhos de v em adj[ini[v]] .. adj[ini[v+1]-1]
+} Grafo_t;
+
+
+// Grafo de A + A^T, na área de trabalho do chamador
+static Grafo_t *grafoSistLinear (SistLinear_t *SL)
+{
+    unsigned int n = SL->n, i, j, k;
+
+    Grafo_t *G = arenaAloca(sizeof(Grafo_t));
+    G->ini = arenaZera(sizeof(unsigned int) * (n + 1));
+
+    for (i = 0; i < n; i++)
+        for (j = i + 1; j < n; j++)
+            if (SL->A[i][j] != 0.0f || SL->A[j][i] != 0.0f){
+                G->ini[i + 1]++;
+                G->ini[j + 1]++;
+            }
+    for (i = 0; i < n; i++)
+        G->ini[i + 1] += G->ini[i];
+
+    G->adj = arenaAloca(sizeof(unsigned int) * G->ini[n]);
+    MarcaArena_t marca = arenaMarca();
+    unsigned int *pos = arenaAloca(sizeof(unsigned int) * n);
+    memcpy(pos, G->ini, sizeof(unsigned int) * n);
+
+    for (i = 0; i < n; i++)
+        for (j = i + 1; j < n; j++)
+            if (SL->A[i][j] != 0.0f || SL->A[j][i] != 0.0f){
+                G->adj[pos[i]++] = j;
+                G->adj[pos[j]++] = i;
+            }
+    arenaRetorna(marca);
+
+    // Ordena os vizinhos por grau (inserção: listas curtas em matrizes esparsas)
+    for (i = 0; i < n; i++)
+        for (k = G->ini[i] + 1; k < G->ini[i + 1]; k++){
+            unsigned int v = G->adj[k], g = G->ini[v + 1] - G->ini[v];
+            for (j = k; j > G->ini[i] && G->ini[G->adj[j - 1] + 1] - G->ini[G->adj[j - 1]] > g; j--)
+                G->adj[j] = G->adj[j - 1];
+            G->adj[j] = v;
+        }
+
+    return G;
+}
+
+
+/*  Busca em largura a partir de 'raiz', numerando os vértices em 'ordem' a
+    partir de 'ini'. Retorna o número de níveis; em 'ultimo' fica o vértice de
+    menor grau do último nível. 'nivel' deve estar em -1 para a componente
+*/
+static unsigned int largura (Grafo_t *G, unsigned int raiz, unsigned int *ordem, unsigned int ini,
+                             int *nivel, unsigned int *fim, unsigned int *ultimo)
+{
+    unsigned int cab = ini, cauda = ini, niveis = 0;
+
+    ordem[cauda++] = raiz;
+    nivel[raiz] = 0;
+    *ultimo = raiz;
+    while (cab < cauda){
+        unsigned int v = ordem[cab++];
+        if ((unsigned int) nivel[v] + 1 > niveis){
+            niveis = nivel[v] + 1;
+            *ultimo = v;
+        }
+        else if (G->ini[v + 1] - G->ini[v] < G->ini[*ultimo + 1] - G->ini[*ultimo])
+            *ultimo = v;
+
+        for (unsigned int k = G->ini[v]; k < G->ini[v + 1]; k++){
+            unsigned int u = G->adj[k];
+            if (nivel[u] < 0){
+                nivel[u] = nivel[v] + 1;
+                ordem[cauda++] = u;
+            }
+        }
+    }
+
+    *fim = cauda;
+    return niveis;
+}
+
+
+unsigned int *ordemRCM (SistLinear_t *SL)
+{
+    unsigned int n = SL->n, i, visitados = 0;
+    MarcaArena_t marca = arenaMarca();
+    Grafo_t *G = grafoSistLinear(SL);
+
+    // 'ordem' passa a ser a permutação do sistema reordenado: fora da área de trabalho
+    unsigned int *ordem = malloc(sizeof(unsigned int) * (n ? n : 1));
+    must_alloc(ordem, __func__);
+    int *nivel = arenaAloca(sizeof(int) * n);
+    int *feito = arenaZera(sizeof(int) * n);
+
+    while (visitados < n){
+        // Início: vértice de menor grau ainda não numerado
+        unsigned int raiz = n, fim, ultimo;
+        for (i = 0; i < n; i++)
+            if (!feito[i] && (raiz == n || G->ini[i + 1] - G->ini[i] < G->ini[raiz + 1] - G->ini[raiz]))
+                raiz = i;
+
+        // Pseudo-periférico: recomeça do último nível enquanto a profundidade aumenta
+        for (i = 0; i < n; i++)
+            if (!feito[i])
+                nivel[i] = -1;
+        unsigned int niveis = largura(G, raiz, ordem, visitados, nivel, &fim, &ultimo);
+        for (;;){
+            for (i = visitados; i < fim; i++)
+                nivel[ordem[i]] = -1;
+            unsigned int outro;
+            unsigned int n2 = largura(G, ultimo, ordem, visitados, nivel, &fim, &outro);
+            if (n2 <= niveis)
+                break;
+            niveis = n2;
+            raiz = ultimo;
+            ultimo = outro;
+        }
+
+        // Numeração final a partir da raiz escolhida
+        for (i = visitados; i < fim; i++)
+            nivel[ordem[i]] = -1;
+        largura(G, raiz, ordem, visitados, nivel, &fim, &ultimo);
+
+        for (i = visitados; i < fim; i++)
+            feito[ordem[i]] = 1;
+        visitados = fim;
+    }
+
+    // Reverse
+    for (i = 0; i < n / 2; i++){
+        unsigned int aux = ordem[i];
+        ordem[i] = ordem[n - 1 - i];
+        ordem[n - 1 - i] = aux;
+    }
+
+    arenaRetorna(marca);
+
+    return ordem;
+}
+
+
+SistLinear_t *permutaSistLinear (SistLinear_t *SL, unsigned int *perm)
+{
+    unsigned int n = SL->n, i, j, c;
+    SistLinear_t *new = alocaSistLinearMultiplo(n, SL->nrhs);
+    new->erro = SL->erro;
+
+    for (i = 0; i < n; i++){
+        real_t *orig = SL->A[perm[i]];
+        for (j = 0; j < n; j++)
+            new->A[i][j] = orig[perm[j]];
+        for (c = 0; c < SL->nrhs; c++)
+            new->b[(size_t) c * n + i] = SL->b[(size_t) c * n + perm[i]];
+    }
+
+    new->perm = perm;
+    detectaBanda(new);
+    return new;
+}
+
+
+unsigned long perfilSistLinear (SistLinear_t *SL)
+{
+    unsigned int n = SL->n, i, j;
+    unsigned long perfil = 0;
+
+    for (i = 0; i < n; i++){
+        for (j = 0; j < i && SL->A[i][j] == 0.0f; j++);
+        perfil += i - j;
+        for (j = 0; j < i && SL->A[j][i] == 0.0f; j++);
+        perfil += i - j;
+    }
+    return perfil;
+}
@@ -0,0 +1,19 @@
+#ifndef __REORDENA_H__
+#define __REORDENA_H__
+
+#include "SistemasLineares.h"
+
+// Ordem Reverse Cuthill-McKee do grafo de A + A^T: a linha/coluna i do
+// sistema reordenado é a linha/coluna perm[i] do original
+unsigned int *ordemRCM (SistLinear_t *SL);
+
+// Sistema P A P^T y = P b, com 'perm' (que passa a pertencer ao novo SL) e
+// a banda preenchidos. A solução original é x[perm[i]] = y[i], como escrita por fprnSolucao
+SistLinear_t *permutaSistLinear (SistLinear_t *SL, unsigned int *perm);
+
+// Perfil (envelope) de A: soma das distâncias entre a diagonal e o primeiro
+// não nulo de cada linha (à esquerda) e de cada coluna (acima). Limita o
+// preenchimento da eliminação sem trocas de linha
+unsigned long perfilSistLinear (SistLinear_t *SL);
+
+#endif // __REORDENA_H__
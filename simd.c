@@ -0,0 +1,188 @@
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86
+#endif
+
+#include "simd.h"
+
+
+// Implementações escalares, usadas como alternativa portável
+
+static double produtoInterno_escalar (const real_t *a, const real_t *b, unsigned int n)
+{
+    double sum = 0.0;
+    for (unsigned int i = 0; i < n; i++)
+        sum += (double) a[i] * b[i];
+    return sum;
+}
+
+
+static double somaQuadrados_escalar (const real_t *v, unsigned int n)
+{
+    double sum = 0.0;
+    for (unsigned int i = 0; i < n; i++)
+        sum += (double) v[i] * v[i];
+    return sum;
+}
+
+
+static real_t distanciaMaxima_escalar (const real_t *a, const real_t *b, unsigned int n)
+{
+    real_t max = 0.0f;
+    for (unsigned int i = 0; i < n; i++)
+        if (fabsf(a[i] - b[i]) > max)
+            max = fabsf(a[i] - b[i]);
+    return max;
+}
+
+
+#ifdef SIMD_X86
+
+// Os núcleos abaixo carregam real_t com intrínsecos _ps (float)
+_Static_assert(sizeof(real_t) == sizeof(float), "simd: real_t deve ser float");
+
+// AVX2: 8 floats por vez, convertidos em dois vetores de 4 doubles
+
+__attribute__((target("avx2,fma")))
+static double produtoInterno_avx2 (const real_t *a, const real_t *b, unsigned int n)
+{
+    __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+    unsigned int i;
+    for (i = 0; i + 8 <= n; i += 8){
+        __m256 va = _mm256_loadu_ps(a + i), vb = _mm256_loadu_ps(b + i);
+        s0 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_castps256_ps128(va)),
+                             _mm256_cvtps_pd(_mm256_castps256_ps128(vb)), s0);
+        s1 = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm256_extractf128_ps(va, 1)),
+                             _mm256_cvtps_pd(_mm256_extractf128_ps(vb, 1)), s1);
+    }
+
+    double t[4], sum;
+    _mm256_storeu_pd(t, _mm256_add_pd(s0, s1));
+    sum = (t[0] + t[1]) + (t[2] + t[3]);
+    for (; i < n; i++)
+        sum += (double) a[i] * b[i];
+    return sum;
+}
+
+
+__attribute__((target("avx2,fma")))
+static double somaQuadrados_avx2 (const real_t *v, unsigned int n)
+{
+    return produtoInterno_avx2(v, v, n);
+}
+
+
+__attribute__((target("avx2")))
+static real_t distanciaMaxima_avx2 (const real_t *a, const real_t *b, unsigned int n)
+{
+    const __m256 sinal = _mm256_set1_ps(-0.0f);
+    __m256 vmax = _mm256_setzero_ps();
+    unsigned int i;
+    for (i = 0; i + 8 <= n; i += 8){
+        __m256 d = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        vmax = _mm256_max_ps(vmax, _mm256_andnot_ps(sinal, d));
+    }
+
+    real_t t[8], max = 0.0f;
+    _mm256_storeu_ps(t, vmax);
+    for (int k = 0; k < 8; k++)
+        if (t[k] > max)
+            max = t[k];
+    for (; i < n; i++)
+        if (fabsf(a[i] - b[i]) > max)
+            max = fabsf(a[i] - b[i]);
+    return max;
+}
+
+
+// AVX-512: 16 floats por vez, convertidos em dois vetores de 8 doubles
+
+__attribute__((target("avx512f")))
+static double produtoInterno_avx512 (const real_t *a, const real_t *b, unsigned int n)
+{
+    __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+    unsigned int i;
+    for (i = 0; i + 16 <= n; i += 16){
+        __m512 va = _mm512_loadu_ps(a + i), vb = _mm512_loadu_ps(b + i);
+        s0 = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm512_castps512_ps256(va)),
+                             _mm512_cvtps_pd(_mm512_castps512_ps256(vb)), s0);
+        s1 = _mm512_fmadd_pd(_mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(va), 1))),
+                             _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(vb), 1))), s1);
+    }
+
+    double sum = _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+    for (; i < n; i++)
+        sum += (double) a[i] * b[i];
+    return sum;
+}
+
+
+__attribute__((target("avx512f")))
+static double somaQuadrados_avx512 (const real_t *v, unsigned int n)
+{
+    return produtoInterno_avx512(v, v, n);
+}
+
+
+__attribute__((target("avx512f")))
+static real_t distanciaMaxima_avx512 (const real_t *a, const real_t *b, unsigned int n)
+{
+    __m512 vmax = _mm512_setzero_ps();
+    unsigned int i;
+    for (i = 0; i + 16 <= n; i += 16){
+        __m512 d = _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+        vmax = _mm512_max_ps(vmax, _mm512_abs_ps(d));
+    }
+
+    real_t max = _mm512_reduce_max_ps(vmax);
+    for (; i < n; i++)
+        if (fabsf(a[i] - b[i]) > max)
+            max = fabsf(a[i] - b[i]);
+    return max;
+}
+
+#endif // SIMD_X86
+
+
+double (*produtoInterno)(const real_t *a, const real_t *b, unsigned int n) = produtoInterno_escalar;
+double (*somaQuadrados)(const real_t *v, unsigned int n) = somaQuadrados_escalar;
+real_t (*distanciaMaxima)(const real_t *a, const real_t *b, unsigned int n) = distanciaMaxima_escalar;
+
+static const char *implementacao = "escalar";
+
+
+// Escolhe as implementações antes de main, de acordo com a CPU. A variável de
+// ambiente SISLIN_SIMD ("escalar" ou "avx2") limita o conjunto de instruções usado
+__attribute__((constructor))
+static void simdInicializa (void)
+{
+#ifdef SIMD_X86
+    const char *limite = getenv("SISLIN_SIMD");
+    int avx512 = !limite || !strcmp(limite, "avx512");
+    int avx2 = avx512 || (limite && !strcmp(limite, "avx2"));
+
+    __builtin_cpu_init();
+    if (avx512 && __builtin_cpu_supports("avx512f")){
+        produtoInterno = produtoInterno_avx512;
+        somaQuadrados = somaQuadrados_avx512;
+        distanciaMaxima = distanciaMaxima_avx512;
+        implementacao = "avx512";
+    }
+    else if (avx2 && __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")){
+        produtoInterno = produtoInterno_avx2;
+        somaQuadrados = somaQuadrados_avx2;
+        distanciaMaxima = distanciaMaxima_avx2;
+        implementacao = "avx2";
+    }
+#endif
+}
+
+
+const char *simdImplementacao (void)
+{
+    return implementacao;
+}
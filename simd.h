@@ -0,0 +1,21 @@
+#ifndef __SIMD_H__
+#define __SIMD_H__
+
+#include "SistemasLineares.h"
+
+// Kernels vetoriais usados nos laços internos dos métodos. A implementação
+// (AVX-512, AVX2 ou escalar) é escolhida em tempo de execução, conforme a CPU.
+
+// Produto interno de 'a' e 'b', acumulado em double
+extern double (*produtoInterno)(const real_t *a, const real_t *b, unsigned int n);
+
+// Soma dos quadrados dos elementos de 'v', acumulada em double
+extern double (*somaQuadrados)(const real_t *v, unsigned int n);
+
+// Maior diferença absoluta entre os elementos de 'a' e 'b'
+extern real_t (*distanciaMaxima)(const real_t *a, const real_t *b, unsigned int n);
+
+// Nome da implementação escolhida ("avx512", "avx2" ou "escalar")
+const char *simdImplementacao(void);
+
+#endif // __SIMD_H__
@@ -1,9 +1,17 @@
 #include "utils.h"
+#include "simd.h"
+#include "arena.h"
+#include "instrumenta.h"
 #include <stdio.h>
 #include <math.h>
 #include <float.h>
 #include <string.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 /*  Retorna tempo em milisegundos
 
@@ -17,9 +25,32 @@
 
 double timestamp(void)
 {
-  struct timeval tp;
-  gettimeofday(&tp, NULL);
-  return((double)(tp.tv_sec*1000.0 + tp.tv_usec/1000.0));
+  // Monotônico: não salta com ajustes do relógio do sistema
+  struct timespec tp;
+  clock_gettime(CLOCK_MONOTONIC, &tp);
+  return((double)(tp.tv_sec*1000.0 + tp.tv_nsec/1000000.0));
+}
+
+
+static int num_threads = 1;
+
+// Define o número de threads dos métodos paralelos. Valores < 1 usam o padrão do OpenMP
+void defineThreads(int n)
+{
+#ifdef _OPENMP
+    if (n < 1)
+        n = omp_get_max_threads();
+    omp_set_num_threads(n);
+    num_threads = n;
+#else
+    num_threads = 1;
+#endif
+}
+
+
+int numThreads(void)
+{
+    return num_threads;
 }
 
 
@@ -33,14 +64,70 @@ void must_alloc(void *ptr, const char *desc)
 }
 
 
+// Distância entre linhas de uma matriz n x n: n arredondado para um múltiplo
+// de SL_LDA_MULTIPLO, mais SL_LDA_MULTIPLO se a linha arredondada ocupar um
+// múltiplo exato de 4 KiB (com float, lda múltiplo de 1024 elementos: n de
+// 1009 a 1024, de 2033 a 2048, de 3057 a 3072...)
+unsigned int calculaLda(unsigned int n)
+{
+    unsigned int lda = (n + SL_LDA_MULTIPLO - 1) / SL_LDA_MULTIPLO * SL_LDA_MULTIPLO;
+    if (lda && (lda * sizeof(real_t)) % 4096 == 0)
+        lda += SL_LDA_MULTIPLO;
+    return lda;
+}
+
+
+// Matriz n x n zerada, com linhas de 'lda' elementos num único bloco
+// alinhado. Blocos grandes são alinhados à página grande e pedem huge pages
+real_t **alocaMatriz(unsigned int n, unsigned int lda)
+{
+    real_t **A = malloc((n ? n : 1) * sizeof(real_t*));
+    must_alloc(A, __func__);
+
+    size_t bytes = (size_t) n * lda * sizeof(real_t), alinhamento = SL_ALINHAMENTO;
+    if (SL_PAGINA_GRANDE && bytes >= SL_PAGINA_GRANDE)
+        alinhamento = (size_t) 2 << 20;
+    bytes = (bytes + alinhamento - 1) / alinhamento * alinhamento;
+
+    real_t *bloco = aligned_alloc(alinhamento, bytes ? bytes : alinhamento);
+    must_alloc(bloco, __func__);
+#ifdef MADV_HUGEPAGE
+    if (alinhamento > SL_ALINHAMENTO)
+        madvise(bloco, bytes, MADV_HUGEPAGE);
+#endif
+    memset(bloco, 0, bytes);
+
+    A[0] = bloco;
+    for (unsigned int i = 1; i < n; i++)
+        A[i] = bloco + (size_t) i * lda;
+    return A;
+}
+
+
+void liberaMatriz(real_t **A)
+{
+    free(A[0]);
+    free(A);
+}
+
+
 // Cria uma cópia de um SL
 SistLinear_t *copiar_SL(SistLinear_t* SL)
 {
-    SistLinear_t *new = alocaSistLinear(SL->n);
+    SistLinear_t *new = alocaSistLinearMultiplo(SL->n, SL->nrhs);
 
-    memcpy(new->A[0], SL->A[0], sizeof(real_t) * SL->n * SL->n);
-    memcpy(new->b, SL->b, sizeof(real_t) * SL->n);
+    // SL pode ter outra distância entre linhas (visão de arquivo mapeado)
+    for (unsigned int i = 0; i < SL->n; i++)
+        memcpy(new->A[i], SL->A[i], sizeof(real_t) * SL->n);
+    memcpy(new->b, SL->b, sizeof(real_t) * SL->n * SL->nrhs);
     new->erro = SL->erro;
+    new->kl = SL->kl;
+    new->ku = SL->ku;
+    if (SL->perm){
+        new->perm = malloc(sizeof(unsigned int) * SL->n);
+        must_alloc(new->perm, __func__);
+        memcpy(new->perm, SL->perm, sizeof(unsigned int) * SL->n);
+    }
 
     return new;
 }
@@ -49,62 +136,92 @@ SistLinear_t *copiar_SL(SistLinear_t* SL)
 // Checa se um número é inoperável
 int invalid(real_t num)
 {
-    if (num == NAN)         return 1;
-    if (num == INFINITY)    return 1;
-    if (num == -INFINITY)   return 1;
-    return 0;
+    return !isfinite(num);
 }
 
 
-// Retrosubstitui as variáveis do sistema para solucioná-lo
-int retrosubs(SistLinear_t* SL)
+// NaN e infinito têm todos os bits de expoente ligados. O teste é feito sobre
+// os bits, sem desvios, para que o laço seja vetorizado. A máscara de expoente
+// é escolhida pelo tamanho de real_t (binary32 ou binary64)
+_Static_assert(sizeof(real_t) == sizeof(uint32_t) || sizeof(real_t) == sizeof(uint64_t),
+               "vetor_invalido: real_t deve ser float ou double");
+
+int vetor_invalido(const real_t *v, unsigned int n)
 {
-    for (int i = SL->n - 1; i >= 0; i--){
-        SL->b[i] /= SL->A[i][i];
-        if (invalid(SL->b[i])){
-            fprintf(stderr, "Retrosubs floating point failure.\n");
-            return -1;
+    int falha = 0;
+    if (sizeof(real_t) == sizeof(uint64_t)){
+        uint64_t bits;
+        for (unsigned int i = 0; i < n; i++){
+            memcpy(&bits, v + i, sizeof(bits));
+            falha |= (bits & 0x7ff0000000000000ull) == 0x7ff0000000000000ull;
         }
-        SL->A[i][i] = 1.0f;
-        for (int j = i - 1; j >= 0; j--){
-            SL->b[j] -= SL->A[j][i] * SL->b[i];
-            if (invalid(SL->b[j])){
-                fprintf(stderr, "Retrosubs floating point failure.\n");
-                return -1;
-            }
-            SL->A[j][i] = 0.0f;
+    }
+    else {
+        uint32_t bits;
+        for (unsigned int i = 0; i < n; i++){
+            memcpy(&bits, v + i, sizeof(bits));
+            falha |= (bits & 0x7f800000u) == 0x7f800000u;
         }
     }
+    return falha;
+}
+
+
+// Retrosubstitui as variáveis do sistema Ux = y. Ao iniciar 'x' contém y
+int retrosubs(FatorLU_t *LU, real_t *x)
+{
+    real_t **U = LU->LU;
+    double sum;
+
+    INSTR_INICIO(FASE_SUBSTITUICAO);
+    for (int i = LU->n - 1; i >= 0; i--){
+        sum = x[i];
+        for (int j = i + 1; j < LU->n; j++)
+            sum -= U[i][j] * x[j];
+        x[i] = sum / U[i][i];
+    }
+    INSTR_FIM(FASE_SUBSTITUICAO);
+
+    // Uma falha em qualquer etapa da solução se propaga até x
+    if (vetor_invalido(x, LU->n)){
+        fprintf(stderr, "Retrosubs floating point failure.\n");
+        return -1;
+    }
     return 0;
 }
 
 
 // Calcula o resíduo de um sistema linear e sua solução
-real_t *residue(SistLinear_t *SL, real_t *x)
+void residue(SistLinear_t *SL, real_t *x, real_t *res)
 {
-    real_t *res = malloc(SL->n * sizeof(real_t));
-    must_alloc(res, __func__);
+    residue_col(SL, x, 0, res);
+}
+
+
+// Calcula o resíduo da solução x para a coluna c de b
+void residue_col(SistLinear_t *SL, real_t *x, unsigned int c, real_t *res)
+{
+    real_t *b = SL->b + (size_t) c * SL->n;
+    for (int i = 0; i < SL->n; i++)
+        res[i] = b[i] - produtoInterno(SL->A[i], x, SL->n);
+}
 
+
+// Calcula o resíduo r = b - Ax inteiramente em double
+void residue_d(SistLinear_t *SL, double *x, double *res)
+{
     int i, k;
     double ax;
 
     for (i = 0; i < SL->n; i++){
-        ax = 0.0f;
+        ax = 0.0;
         for (k = 0; k < SL->n; k++)
-            ax += SL->A[i][k] * x[k];
+            ax += (double) SL->A[i][k] * x[k];
         res[i] = SL->b[i] - ax;
     }
-    
-    return res;
 }
 
 
-void free_these(void **ptrs, unsigned int n)
-{
-    for (int i = 0; i < n; i++)
-        free(ptrs[i]);
-    free(ptrs);
-}
 
 
 int jacobi_converge(SistLinear_t *SL)
@@ -127,8 +244,8 @@ int jacobi_converge(SistLinear_t *SL)
 
 int seidel_converge(SistLinear_t *SL)
 {
-    double *betas = malloc(sizeof(double) * SL->n);
-    must_alloc(betas, __func__);
+    MarcaArena_t marca = arenaMarca();
+    double *betas = arenaAloca(sizeof(double) * SL->n);
 
     int i, j;
     double sum;
@@ -142,11 +259,21 @@ int seidel_converge(SistLinear_t *SL)
 
         betas[i] = sum / fabs(SL->A[i][i]);
         if (betas[i] > 1.0f){
-            free(betas);
+            arenaRetorna(marca);
             return 0;
         }
     }
-    free(betas);
+    arenaRetorna(marca);
+    return 1;
+}
+
+
+int simetrica(SistLinear_t *SL)
+{
+    for (int i = 0; i < SL->n; i++)
+        for (int j = i + 1; j < SL->n; j++)
+            if (fabsf(SL->A[i][j] - SL->A[j][i]) > FLT_EPSILON * (fabsf(SL->A[i][j]) + fabsf(SL->A[j][i])))
+                return 0;
     return 1;
 }
 
@@ -154,45 +281,114 @@ int seidel_converge(SistLinear_t *SL)
 // Compara todos os elementos de dois vetores e ve se a diferença entre eles são muito diferentes (baseado no erro)
 int too_different(real_t* prev, real_t* curr, unsigned int n, real_t error)
 {
-    for (int i = 0; i < n; i++)
-        if (fabs(curr[i] - prev[i]) > error)
-            return 1;
-    return 0;
+    INSTR_INICIO(FASE_CONVERGENCIA);
+    int diferentes = distanciaMaxima(prev, curr, n) > error;
+    INSTR_FIM(FASE_CONVERGENCIA);
+    return diferentes;
 }
 
 
-real_t max_distance(real_t *a, real_t *b, unsigned int n)
+// Colore as linhas de SL de forma que duas linhas i e j com A[i][j] ou A[j][i]
+// não nulos tenham cores diferentes. Cada linha recebe a menor cor livre.
+// A coloração fica na área de trabalho, até liberaColoracao
+Coloracao_t *coloreSistLinear(SistLinear_t *SL)
 {
-    real_t diff, max = fabs(a[0] - b[0]);
-    for (int i = 1; i < n; i++){
-        diff = fabs(a[i] - b[i]);
-        if (diff > max)
-            max = diff;
+    unsigned int n = SL->n, i, j, c;
+    MarcaArena_t inicial = arenaMarca();
+
+    Coloracao_t *C = arenaAloca(sizeof(Coloracao_t));
+    C->marca = inicial;
+    C->ordem = arenaAloca(n * sizeof(unsigned int));
+
+    // Temporários: ao fim, C->inicio ocupa o lugar deles
+    MarcaArena_t temporarios = arenaMarca();
+    unsigned int *cor = arenaAloca(n * sizeof(unsigned int));
+    unsigned int *marca = arenaZera((n + 1) * sizeof(unsigned int)); // marca[c] == i + 1: cor c usada por vizinho de i
+
+    C->ncores = 0;
+    for (i = 0; i < n; i++){
+        for (j = 0; j < i; j++)
+            if (SL->A[i][j] != 0.0f || SL->A[j][i] != 0.0f)
+                marca[cor[j]] = i + 1;
+
+        for (c = 0; marca[c] == i + 1; c++);
+        cor[i] = c;
+        if (c + 1 > C->ncores)
+            C->ncores = c + 1;
     }
-    return max;
+
+    // marca[] tem n + 1 >= ncores + 1 posições: passa a ser o início de cada cor
+    unsigned int *inicio = marca;
+    memset(inicio, 0, (C->ncores + 1) * sizeof(unsigned int));
+    for (i = 0; i < n; i++)
+        inicio[cor[i] + 1]++;
+    for (c = 0; c < C->ncores; c++)
+        inicio[c + 1] += inicio[c];
+
+    for (i = 0; i < n; i++)
+        C->ordem[inicio[cor[i]]++] = i;
+
+    // inicio[c] avançou até o início da cor c + 1
+    for (c = C->ncores; c > 0; c--)
+        inicio[c] = inicio[c - 1];
+    inicio[0] = 0;
+
+    arenaRetorna(temporarios);
+    C->inicio = arenaAloca((C->ncores + 1) * sizeof(unsigned int));
+    memmove(C->inicio, inicio, (C->ncores + 1) * sizeof(unsigned int));
+
+    return C;
 }
 
 
-int refine(SistLinear_t *SL, real_t *x)
+void liberaColoracao(Coloracao_t *C)
 {
-    SistLinear_t *clone = copiar_SL(SL);
+    arenaRetorna(C->marca);
+}
 
-    real_t *res = residue(SL, x);
 
-    real_t *w = malloc(SL->n * sizeof(real_t));
-    must_alloc(w, __func__);
-    
-    memcpy(clone->b, res, sizeof(real_t) * SL->n);
+real_t max_distance(real_t *a, real_t *b, unsigned int n)
+{
+    return distanciaMaxima(a, b, n);
+}
+
 
-    double time;
-    int result = eliminacaoGauss(clone, w, &time);
-    
-    if (result >= 0) // Caso tenha dado tudo certo
-        for (int i = 0; i < SL->n; i++)
-            x[i] = x[i] + w[i];
+/*  Aplica um passo de refinamento de precisão mista: o resíduo e a atualização
+    de x são feitos em double e a correção Aw = r é resolvida com a fatoração
+    em real_t. O resíduo é escalado pela sua norma máxima antes de ser
+    convertido, evitando underflow quando já é muito pequeno.
+    Em 'dx_norma' retorna a norma máxima da correção aplicada.
+*/
+int refine(SistLinear_t *SL, FatorLU_t *LU, double *x, double *dx_norma)
+{
+    MarcaArena_t marca = arenaMarca();
+    double *res = arenaAloca(SL->n * sizeof(double));
+    real_t *r = arenaAloca(SL->n * sizeof(real_t));
+    real_t *w = arenaAloca(SL->n * sizeof(real_t));
+
+    int i, result = 0;
+    double escala = 0.0;
+
+    residue_d(SL, x, res);
+    for (i = 0; i < SL->n; i++)
+        if (fabs(res[i]) > escala)
+            escala = fabs(res[i]);
+
+    *dx_norma = 0.0;
+    if (escala > 0.0){ // Resíduo nulo: x já é solução
+        for (i = 0; i < SL->n; i++)
+            r[i] = (real_t) (res[i] / escala);
+
+        result = luSolve(LU, r, w);
+        if (result >= 0) // Caso tenha dado tudo certo
+            for (i = 0; i < SL->n; i++){
+                x[i] += escala * w[i];
+                if (fabs(escala * w[i]) > *dx_norma)
+                    *dx_norma = fabs(escala * w[i]);
+            }
+    }
 
-    free(res);
-    free(w);
+    arenaRetorna(marca);
 
     return result;
 }
\ No newline at end of file
@@ -2,30 +2,59 @@
 #define __UTILS_H__
 
 #include <stdlib.h>
-#include <sys/time.h>
+#include <time.h>
 #include "SistemasLineares.h"
+#include "arena.h"
 
 #define MAXNORMA 5.0f
 
 double timestamp(void);
 
+// Coloração das linhas de um SL: linhas de mesma cor não dependem umas das outras
+typedef struct {
+  unsigned int ncores; // número de cores
+  unsigned int *ordem; // linhas agrupadas por cor
+  unsigned int *inicio; // linhas da cor c estão em ordem[inicio[c]] .. ordem[inicio[c+1]-1]
+  MarcaArena_t marca; // posição da área de trabalho antes da coloração
+} Coloracao_t;
+
+// Define/consulta o número de threads usado pelos métodos paralelos
+void defineThreads(int n);
+int numThreads(void);
+
 // Certifica que a memória foi alocada
 void must_alloc(void *ptr, const char *desc);
 
-// Libera toda a memória apontada por ptrs, inclusive ptrs 
-void free_these(void **ptrs, unsigned int n);
+
+// Distância entre linhas (lda) das matrizes n x n alocadas por alocaMatriz
+unsigned int calculaLda(unsigned int n);
+
+// Aloca uma matriz n x n zerada: tabela de linhas apontando para um bloco
+// alinhado a SL_ALINHAMENTO, linha i em A[0] + i*lda
+real_t **alocaMatriz(unsigned int n, unsigned int lda);
+void liberaMatriz(real_t **A);
 
 // Cria uma cópia de um SistLinear_t
 SistLinear_t *copiar_SL(SistLinear_t* SL);
 
-// Retrosubstitui as variáveis do sistema para solucioná-lo
-int retrosubs(SistLinear_t* SL);
+// Retrosubstitui as variáveis do sistema triangular superior U da fatoração
+int retrosubs(FatorLU_t *LU, real_t *x);
 
-// Verifica se um número é invalido
+// Verifica se um número é invalido (NaN ou infinito)
 int invalid(real_t num);
 
-// Calcula o resíduo de um sistema linear e sua solução
-real_t *residue(SistLinear_t *SL, real_t *x);
+// Verifica se algum elemento de um vetor é inválido. Feita uma vez por
+// linha/painel/iteração em vez de a cada operação dos laços internos
+int vetor_invalido(const real_t *v, unsigned int n);
+
+// Calcula em res (n posições) o resíduo de um sistema linear e sua solução
+void residue(SistLinear_t *SL, real_t *x, real_t *res);
+
+// Calcula em res o resíduo da solução x para a coluna c dos termos independentes
+void residue_col(SistLinear_t *SL, real_t *x, unsigned int c, real_t *res);
+
+// Calcula o resíduo em precisão dupla para uma solução em precisão dupla
+void residue_d(SistLinear_t *SL, double *x, double *res);
 
 // Verifica se o sistema converge utilizando iteações de Gauss-Jacobi
 int jacobi_converge(SistLinear_t *SL);
@@ -33,11 +62,20 @@ int jacobi_converge(SistLinear_t *SL);
 // Verifica se o sistema converge utilizando iteações de Gauss-Seidel
 int seidel_converge(SistLinear_t *SL);
 
+// Verifica se A é simétrica (a menos do arredondamento de real_t)
+int simetrica(SistLinear_t *SL);
+
 // Retorna a distância máxima entre os elementos de um vetor
 real_t max_distance(real_t *a, real_t *b, unsigned int n);
 
-// Refina uma resultado
-int refine(SistLinear_t *SL, real_t *x);
+// Refina uma resultado em precisão dupla usando a fatoração LU (real_t) de SL
+int refine(SistLinear_t *SL, FatorLU_t *LU, double *x, double *dx_norma);
+
+// Colore o grafo de adjacência de A (guloso, na ordem natural das linhas).
+// A coloração fica na área de trabalho: liberaColoracao descarta também o
+// que foi reservado nela depois
+Coloracao_t *coloreSistLinear(SistLinear_t *SL);
+void liberaColoracao(Coloracao_t *C);
 
 // Verifica se as duas soluções são muito diferentes
 int too_different(real_t* prev, real_t* curr, unsigned int n, real_t error);